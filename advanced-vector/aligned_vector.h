@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "vector.h"
+
+// Аллокатор, выравнивающий буфер по Align байт (но не слабее alignof(T)) через
+// выравнивающие operator new/delete. Нужен, чтобы SIMD-циклы с выровненными
+// загрузками (AVX2, AVX-512) обходили данные вектора без пролога
+template <typename T, size_t Align>
+class AlignedAllocator {
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Alignment must be a power of two");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t kAlignment = Align > alignof(T) ? Align : alignof(T);
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        operator delete(p, n * sizeof(T), std::align_val_t(kAlignment));
+    }
+};
+
+template <typename T, typename U, size_t Align>
+bool operator==(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U, size_t Align>
+bool operator!=(const AlignedAllocator<T, Align>&, const AlignedAllocator<U, Align>&) noexcept {
+    return false;
+}
+
+// Вектор, данные которого выровнены по Align байт
+template <typename T, size_t Align = 64, typename GrowthPolicy = DoublingGrowth>
+using AlignedVector = Vector<T, AlignedAllocator<T, Align>, GrowthPolicy>;
@@ -0,0 +1,337 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "growth_policy.h"
+#include "simd_kernels.h"
+#include "vector.h"
+
+// Вектор флагов по одному биту на флаг в 64-битных словах. Слова хранятся в RawMemory
+// и растут по GrowthPolicy, как у Vector. Побитовые операции, Count и поиск единиц
+// обрабатывают слова SIMD-ядрами. Биты последнего слова за пределами размера всегда нулевые
+template <typename Allocator = std::allocator<uint64_t>, typename GrowthPolicy = DoublingGrowth>
+class BitVector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using allocator_type = Allocator;
+
+    static constexpr size_t kWordBits = 64;
+    // Результат поиска, если единичного бита нет
+    static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+    BitVector() = default;
+
+    explicit BitVector(const Allocator& alloc) noexcept
+        : words_(alloc) {
+    }
+
+    explicit BitVector(size_t size, bool value = false, const Allocator& alloc = Allocator())
+        : words_(WordsFor(size), alloc)
+        , size_(size) {
+        std::fill_n(words_.GetAddress(), WordCount(), value ? ~uint64_t{0} : uint64_t{0});
+        ClearUnusedBits();
+    }
+
+    BitVector(const BitVector& other)
+        : words_(other.WordCount(), AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+        , size_(other.size_) {
+        std::copy_n(other.Words(), other.WordCount(), words_.GetAddress());
+    }
+
+    BitVector(BitVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    BitVector& operator=(const BitVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Текущие слова принадлежат старому аллокатору
+                    size_ = 0;
+                    words_.Reset(rhs.GetAllocator());
+                } else {
+                    words_.SetAllocator(rhs.GetAllocator());
+                }
+            }
+            if (rhs.WordCount() > words_.Capacity()) {
+                RawMemory<uint64_t, Allocator> new_words(rhs.WordCount(), GetAllocator());
+                words_.Swap(new_words);
+            }
+            std::copy_n(rhs.Words(), rhs.WordCount(), words_.GetAddress());
+            size_ = rhs.size_;
+        }
+        return *this;
+    }
+
+    BitVector& operator=(BitVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                   || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (AllocTraits::propagate_on_container_move_assignment::value
+                || GetAllocator() == rhs.GetAllocator()) {
+                words_ = std::move(rhs.words_);
+                size_ = std::exchange(rhs.size_, 0);
+            } else {
+                // Чужой буфер забрать нельзя: копируем слова в память своего аллокатора
+                RawMemory<uint64_t, Allocator> new_words(rhs.WordCount(), GetAllocator());
+                std::copy_n(rhs.Words(), rhs.WordCount(), new_words.GetAddress());
+                words_.Swap(new_words);
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+
+    void Swap(BitVector& other) noexcept {
+        words_.Swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return words_.Capacity() * kWordBits;
+    }
+
+    // Число слов, занятых битами вектора
+    size_t WordCount() const noexcept {
+        return WordsFor(size_);
+    }
+
+    const uint64_t* Words() const noexcept {
+        return words_.GetAddress();
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return words_.GetAllocator();
+    }
+
+    bool Test(size_t index) const noexcept {
+        assert(index < size_);
+        return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+
+    bool operator[](size_t index) const noexcept {
+        return Test(index);
+    }
+
+    void Set(size_t index, bool value = true) noexcept {
+        assert(index < size_);
+        uint64_t& word = words_[index / kWordBits];
+        const uint64_t mask = uint64_t{1} << (index % kWordBits);
+        word = value ? (word | mask) : (word & ~mask);
+    }
+
+    void Reset(size_t index) noexcept {
+        Set(index, false);
+    }
+
+    void Flip(size_t index) noexcept {
+        assert(index < size_);
+        words_[index / kWordBits] ^= uint64_t{1} << (index % kWordBits);
+    }
+
+    // Инвертирует все биты
+    BitVector& Flip() noexcept {
+        SimdTransformWords(words_.GetAddress(), Words(), Words(), WordCount(), [](uint64_t word, uint64_t) {
+            return ~word;
+        });
+        ClearUnusedBits();
+        return *this;
+    }
+
+    void Reserve(size_t new_capacity) {
+        const size_t new_words = WordsFor(new_capacity);
+        if (new_words > words_.Capacity()) {
+            ReallocateWords(new_words);
+        }
+    }
+
+    void ShrinkToFit() {
+        if (WordCount() == words_.Capacity()) {
+            return;
+        }
+        if (size_ == 0) {
+            words_ = RawMemory<uint64_t, Allocator>(GetAllocator());
+            return;
+        }
+        ReallocateWords(WordCount());
+    }
+
+    void Resize(size_t new_size, bool value = false) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            if (value && size_ % kWordBits != 0) {
+                words_[size_ / kWordBits] |= ~uint64_t{0} << (size_ % kWordBits);
+            }
+            std::fill(words_ + WordCount(), words_ + WordsFor(new_size), value ? ~uint64_t{0} : uint64_t{0});
+        }
+        size_ = new_size;
+        ClearUnusedBits();
+    }
+
+    void PushBack(bool value) {
+        if (size_ == Capacity()) {
+            ReallocateWords(GrowthPolicy::template NextCapacity<uint64_t>(words_.Capacity()));
+        }
+        if (size_ % kWordBits == 0) {
+            words_[size_ / kWordBits] = 0;
+        }
+        words_[size_ / kWordBits] |= uint64_t{value} << (size_ % kWordBits);
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        ClearUnusedBits();
+    }
+
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    // Побитовые операции над векторами одного размера
+    BitVector& operator&=(const BitVector& rhs) noexcept {
+        return Combine(rhs, std::bit_and<uint64_t>());
+    }
+
+    BitVector& operator|=(const BitVector& rhs) noexcept {
+        return Combine(rhs, std::bit_or<uint64_t>());
+    }
+
+    BitVector& operator^=(const BitVector& rhs) noexcept {
+        return Combine(rhs, std::bit_xor<uint64_t>());
+    }
+
+    // Число единичных бит
+    size_t Count() const noexcept {
+        return SimdPopCount(Words(), WordCount());
+    }
+
+    bool Any() const noexcept {
+        return FindFirst() != kNotFound;
+    }
+
+    bool None() const noexcept {
+        return !Any();
+    }
+
+    // Индекс первого единичного бита или kNotFound
+    size_t FindFirst() const noexcept {
+        return FindFrom(0);
+    }
+
+    // Индекс первого единичного бита после pos или kNotFound
+    size_t FindNext(size_t pos) const noexcept {
+        return pos + 1 < size_ ? FindFrom(pos + 1) : kNotFound;
+    }
+
+private:
+    static size_t WordsFor(size_t bits) noexcept {
+        return bits / kWordBits + (bits % kWordBits != 0);
+    }
+
+    template <typename Op>
+    BitVector& Combine(const BitVector& rhs, Op op) noexcept {
+        assert(size_ == rhs.size_);
+        SimdTransformWords(words_.GetAddress(), Words(), rhs.Words(), WordCount(), op);
+        return *this;
+    }
+
+    static constexpr size_t kInlineScanWords = 8;
+
+    // Ненулевые слова дальше kInlineScanWords ищутся SIMD-ядром
+    size_t FindFrom(size_t pos) const noexcept {
+        const size_t word_count = WordCount();
+        const size_t word = pos / kWordBits;
+        if (word >= word_count) {
+            return kNotFound;
+        }
+        const uint64_t first = words_[word] & (~uint64_t{0} << (pos % kWordBits));
+        if (first != 0) {
+            return word * kWordBits + __builtin_ctzll(first);
+        }
+        // Ближайшие слова проверяются на месте: для плотных векторов вызов ядра дороже поиска
+        const size_t near_end = std::min(word_count, word + 1 + kInlineScanWords);
+        size_t next = word + 1;
+        while (next < near_end && words_[next] == 0) {
+            ++next;
+        }
+        if (next == near_end && near_end < word_count) {
+            next += SimdFindNot(Words() + next, word_count - next, uint64_t{0});
+        }
+        return next == word_count ? kNotFound : next * kWordBits + __builtin_ctzll(words_[next]);
+    }
+
+    void ClearUnusedBits() noexcept {
+        if (size_ % kWordBits != 0) {
+            words_[size_ / kWordBits] &= (uint64_t{1} << (size_ % kWordBits)) - 1;
+        }
+    }
+
+    // Слова тривиально переносимы: буфер растёт на месте, через Reallocate аллокатора
+    // или копированием занятых слов
+    void ReallocateWords(size_t new_words) {
+        if (words_.TryExpand(new_words)) {
+            return;
+        }
+        if constexpr (RawMemory<uint64_t, Allocator>::kCanReallocate) {
+            words_.Reallocate(new_words);
+        } else {
+            RawMemory<uint64_t, Allocator> new_data(new_words, GetAllocator());
+            std::copy_n(Words(), std::min(WordCount(), new_words), new_data.GetAddress());
+            words_.Swap(new_data);
+        }
+    }
+
+    RawMemory<uint64_t, Allocator> words_;
+    size_t size_ = 0;
+};
+
+template <typename Allocator, typename GrowthPolicy>
+bool operator==(const BitVector<Allocator, GrowthPolicy>& lhs, const BitVector<Allocator, GrowthPolicy>& rhs) {
+    return lhs.Size() == rhs.Size() && SimdMismatch(lhs.Words(), rhs.Words(), lhs.WordCount()) == lhs.WordCount();
+}
+
+template <typename Allocator, typename GrowthPolicy>
+bool operator!=(const BitVector<Allocator, GrowthPolicy>& lhs, const BitVector<Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BitVector<Allocator, GrowthPolicy> operator&(BitVector<Allocator, GrowthPolicy> lhs,
+                                             const BitVector<Allocator, GrowthPolicy>& rhs) {
+    lhs &= rhs;
+    return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BitVector<Allocator, GrowthPolicy> operator|(BitVector<Allocator, GrowthPolicy> lhs,
+                                             const BitVector<Allocator, GrowthPolicy>& rhs) {
+    lhs |= rhs;
+    return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BitVector<Allocator, GrowthPolicy> operator^(BitVector<Allocator, GrowthPolicy> lhs,
+                                             const BitVector<Allocator, GrowthPolicy>& rhs) {
+    lhs ^= rhs;
+    return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BitVector<Allocator, GrowthPolicy> operator~(BitVector<Allocator, GrowthPolicy> vector) {
+    vector.Flip();
+    return vector;
+}
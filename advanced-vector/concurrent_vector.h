@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "growth_policy.h"
+#include "segment_layout.h"
+
+// Вектор только для дописывания, в который потоки добавляют элементы без блокировок.
+// Элементы хранятся в сегментах, каждый следующий вдвое больше предыдущего, поэтому при
+// росте ничего не переносится и адреса элементов стабильны. PushBack/EmplaceBack
+// возвращают индекс, по которому элемент можно читать из любого потока после публикации
+template <typename T>
+class ConcurrentVector {
+    // Ячейка с признаком публикации: элемент доступен читателям, только когда ready == true
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        // Нули означают пустую ячейку, поэтому сегмент можно выделять обнулённой памятью
+        std::atomic<bool> ready;
+
+        T* Get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+public:
+    using Layout = SegmentLayout<6>;
+    static constexpr size_t kMaxSegments = Layout::kMaxSegments;
+
+    ConcurrentVector() = default;
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    // Не потокобезопасен: к моменту разрушения все потоки должны закончить работу с вектором
+    // Обходятся только ячейки с индексами меньше Size(): хвост последнего сегмента
+    // не читается, и его нетронутые страницы не подгружаются
+    ~ConcurrentVector() {
+        const auto [last_segment, last_offset] = Layout::Locate(size_.load(std::memory_order_acquire));
+        for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+            Slot* slots = segments_[segment].load(std::memory_order_acquire);
+            if (slots == nullptr) {
+                continue;
+            }
+            const size_t used = segment < last_segment ? Layout::SegmentSize(segment)
+                                : segment == last_segment ? last_offset
+                                                          : 0;
+            for (size_t i = 0; i < used; ++i) {
+                if (slots[i].ready.load(std::memory_order_relaxed)) {
+                    std::destroy_at(slots[i].Get());
+                }
+            }
+            FreeSegment(slots, segment);
+        }
+    }
+
+    // Число выданных индексов. Элементы с меньшими индексами могут быть ещё не опубликованы
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    size_t PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+
+    size_t PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Конструирует элемент в новой ячейке и публикует его. Если конструктор бросает
+    // исключение, выданный индекс остаётся пустым и никогда не публикуется
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        const auto [segment, offset] = Layout::Locate(index);
+        Slot& slot = GetSegment(segment)[offset];
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.ready.store(true, std::memory_order_release);
+        return index;
+    }
+
+    // Опубликован ли элемент index
+    bool IsPublished(size_t index) const noexcept {
+        return FindSlot(index) != nullptr;
+    }
+
+    // Указатель на опубликованный элемент index или nullptr, если он ещё не готов
+    const T* TryGet(size_t index) const noexcept {
+        Slot* slot = FindSlot(index);
+        return slot != nullptr ? slot->Get() : nullptr;
+    }
+
+    T* TryGet(size_t index) noexcept {
+        Slot* slot = FindSlot(index);
+        return slot != nullptr ? slot->Get() : nullptr;
+    }
+
+    // Элемент index должен быть опубликован
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        T* value = TryGet(index);
+        assert(value != nullptr);
+        return *value;
+    }
+
+    // Вызывает func(index, element) для опубликованных элементов с индексами меньше Size()
+    template <typename Func>
+    void ForEach(Func func) const {
+        const size_t size = Size();
+        for (size_t index = 0; index < size; ++index) {
+            if (const T* value = TryGet(index)) {
+                func(index, *value);
+            }
+        }
+    }
+
+private:
+    // Большие блоки calloc получает от ОС уже обнулёнными и отображает лениво, поэтому
+    // сегмент, выделенный проигравшим гонку потоком, освобождается почти бесплатно
+    static Slot* AllocateSegment(size_t segment) {
+        if constexpr (alignof(Slot) <= alignof(std::max_align_t) && std::is_trivially_default_constructible_v<Slot>) {
+            void* slots = std::calloc(Layout::SegmentSize(segment), sizeof(Slot));
+            if (slots == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<Slot*>(slots);
+        } else {
+            return new Slot[Layout::SegmentSize(segment)]();
+        }
+    }
+
+    static void FreeSegment(Slot* slots, [[maybe_unused]] size_t segment) noexcept {
+        if constexpr (alignof(Slot) <= alignof(std::max_align_t) && std::is_trivially_default_constructible_v<Slot>) {
+            std::free(slots);
+        } else {
+            delete[] slots;
+        }
+    }
+
+    // Возвращает сегмент, выделяя его при первом обращении. Поток, проигравший гонку
+    // за установку указателя, освобождает свой сегмент и берёт чужой
+    Slot* GetSegment(size_t segment) {
+        assert(segment < kMaxSegments);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots != nullptr) {
+            return slots;
+        }
+        Slot* fresh = AllocateSegment(segment);
+        if (segments_[segment].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return fresh;
+        }
+        FreeSegment(fresh, segment);
+        return slots;
+    }
+
+    Slot* FindSlot(size_t index) const noexcept {
+        if (index >= Size()) {
+            return nullptr;
+        }
+        const auto [segment, offset] = Layout::Locate(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots == nullptr || !slots[offset].ready.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[offset];
+    }
+
+    std::atomic<Slot*> segments_[kMaxSegments] = {};
+    // Счётчик изменяется всеми пишущими потоками: отдельная кэш-линия не мешает чтению segments_
+    alignas(kCacheLineSize) std::atomic<size_t> size_{0};
+};
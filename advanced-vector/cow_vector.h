@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор с копированием при записи. Копии разделяют один буфер со счётчиком ссылок,
+// поэтому копирование стоит O(1). Первый изменяющий вызов у разделённой копии
+// (PushBack, неконстантный operator[] или begin, Erase и т. д.) копирует элементы
+// в собственный буфер. Счётчик атомарный: копии можно отдавать другим потокам
+// и читать там, пока исходный вектор изменяется. Сам объект CowVector, как и
+// std::shared_ptr, нельзя одновременно изменять и копировать из разных потоков.
+//
+// Ссылки и итераторы, полученные неконстантным доступом, остаются указывать в буфер,
+// который после копирования вектора становится общим: писать через них после
+// копирования нельзя, нужно заново получить их от вектора
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class CowVector {
+public:
+    using VectorType = Vector<T, Allocator, GrowthPolicy>;
+    using allocator_type = Allocator;
+    using iterator = typename VectorType::iterator;
+    using const_iterator = typename VectorType::const_iterator;
+
+    CowVector() noexcept = default;
+
+    explicit CowVector(size_t size, const Allocator& alloc = Allocator())
+        : buffer_(new Buffer(size, alloc)) {
+    }
+
+    CowVector(std::initializer_list<T> values, const Allocator& alloc = Allocator())
+        : buffer_(new Buffer(alloc)) {
+        buffer_->vector.Insert(buffer_->vector.cend(), values);
+    }
+
+    // Забирает элементы vector без копирования
+    explicit CowVector(VectorType&& vector)
+        : buffer_(new Buffer(std::move(vector))) {
+    }
+
+    CowVector(const CowVector& other) noexcept
+        : buffer_(other.buffer_) {
+        AddRef();
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : buffer_(std::exchange(other.buffer_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        if (buffer_ != rhs.buffer_) {
+            Release();
+            buffer_ = rhs.buffer_;
+            AddRef();
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Release();
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+        }
+        return *this;
+    }
+
+    ~CowVector() {
+        Release();
+    }
+
+    // Снимок текущего содержимого за O(1). То же, что копирование
+    CowVector Snapshot() const noexcept {
+        return *this;
+    }
+
+    // Содержимое в виде Vector без копирования
+    const VectorType& AsVector() const noexcept {
+        return buffer_ != nullptr ? buffer_->vector : EmptyVector();
+    }
+
+    // Число векторов, разделяющих буфер (0 у пустого вектора без буфера)
+    size_t UseCount() const noexcept {
+        return buffer_ != nullptr ? buffer_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    // true, если буфер разделён с другими копиями и изменение приведёт к копированию
+    bool IsShared() const noexcept {
+        return UseCount() > 1;
+    }
+
+    size_t Size() const noexcept {
+        return AsVector().Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return AsVector().Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return AsVector()[index];
+    }
+
+    // Отделяет буфер, если он разделён
+    T& operator[](size_t index) {
+        assert(index < Size());
+        return Mutable()[index];
+    }
+
+    const_iterator begin() const noexcept {
+        return AsVector().begin();
+    }
+    const_iterator end() const noexcept {
+        return AsVector().end();
+    }
+    const_iterator cbegin() const noexcept {
+        return AsVector().begin();
+    }
+    const_iterator cend() const noexcept {
+        return AsVector().end();
+    }
+    // Неконстантные итераторы отделяют буфер, если он разделён
+    iterator begin() {
+        return Mutable().begin();
+    }
+    iterator end() {
+        return Mutable().end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity() || IsShared()) {
+            Mutable(new_capacity).Reserve(new_capacity);
+        }
+    }
+
+    void ShrinkToFit() {
+        Mutable().ShrinkToFit();
+    }
+
+    // Разделённый буфер не копируется, а отпускается: вектор получает новый пустой буфер
+    // с тем же аллокатором. При исключении вектор не меняется
+    void Clear() {
+        if (IsShared()) {
+            Buffer* empty = new Buffer(buffer_->vector.GetAllocator());
+            Release();
+            buffer_ = empty;
+        } else if (buffer_ != nullptr) {
+            buffer_->vector.Clear();
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Mutable(new_size).Resize(new_size);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() {
+        Mutable().PopBack();
+    }
+
+    // args могут ссылаться на элементы разделённого буфера: он живёт до конца вставки
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        Buffer* old = AddRefIfShared();
+        try {
+            T& result = Mutable(Size() + 1).EmplaceBack(std::forward<Args>(args)...);
+            Release(old);
+            return result;
+        } catch (...) {
+            Release(old);
+            throw;
+        }
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = std::distance(cbegin(), pos);
+        Buffer* old = AddRefIfShared();
+        try {
+            VectorType& vector = Mutable(Size() + 1);
+            const iterator result = vector.Emplace(vector.cbegin() + index, std::forward<Args>(args)...);
+            Release(old);
+            return result;
+        } catch (...) {
+            Release(old);
+            throw;
+        }
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t index = std::distance(cbegin(), pos);
+        VectorType& vector = Mutable();
+        return vector.Erase(vector.cbegin() + index);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t index = std::distance(cbegin(), first);
+        const size_t count = std::distance(first, last);
+        VectorType& vector = Mutable();
+        return vector.Erase(vector.cbegin() + index, vector.cbegin() + index + count);
+    }
+
+    const_iterator Find(const T& value) const {
+        return AsVector().Find(value);
+    }
+
+    size_t Count(const T& value) const {
+        return AsVector().Count(value);
+    }
+
+    bool Contains(const T& value) const {
+        return AsVector().Contains(value);
+    }
+
+    decltype(auto) Min() const {
+        return AsVector().Min();
+    }
+
+    decltype(auto) Max() const {
+        return AsVector().Max();
+    }
+
+    auto Sum() const {
+        return AsVector().Sum();
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+    }
+
+private:
+    struct Buffer {
+        template <typename... Args>
+        explicit Buffer(Args&&... args)
+            : vector(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> refs{1};
+        VectorType vector;
+    };
+
+    static const VectorType& EmptyVector() noexcept {
+        static const VectorType empty;
+        return empty;
+    }
+
+    void AddRef() const noexcept {
+        if (buffer_ != nullptr) {
+            buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void Release(Buffer* buffer) noexcept {
+        if (buffer != nullptr && buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete buffer;
+        }
+    }
+
+    void Release() noexcept {
+        Release(buffer_);
+    }
+
+    // Удерживает разделённый буфер, пока аргументы вставки могут ссылаться на его элементы
+    Buffer* AddRefIfShared() const noexcept {
+        if (!IsShared()) {
+            return nullptr;
+        }
+        AddRef();
+        return buffer_;
+    }
+
+    // Возвращает собственный вектор, копируя разделённый буфер. Новый буфер сразу
+    // получает ёмкость не меньше min_capacity и прежней ёмкости, чтобы следующий за
+    // копированием рост не потребовал второго выделения памяти.
+    // При исключении вектор не меняется
+    VectorType& Mutable(size_t min_capacity = 0) {
+        if (buffer_ == nullptr) {
+            buffer_ = new Buffer();
+        } else if (IsShared()) {
+            const VectorType& source = buffer_->vector;
+            auto copy = std::make_unique<Buffer>(source.GetAllocator());
+            copy->vector.Reserve(std::max(min_capacity, source.Capacity()));
+            copy->vector.Insert(copy->vector.cend(), source.begin(), source.end());
+            Release();
+            buffer_ = copy.release();
+        }
+        return buffer_->vector;
+    }
+
+    Buffer* buffer_ = nullptr;
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator==(const CowVector<T, Allocator, GrowthPolicy>& lhs, const CowVector<T, Allocator, GrowthPolicy>& rhs) {
+    return lhs.AsVector() == rhs.AsVector();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator!=(const CowVector<T, Allocator, GrowthPolicy>& lhs, const CowVector<T, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator<(const CowVector<T, Allocator, GrowthPolicy>& lhs, const CowVector<T, Allocator, GrowthPolicy>& rhs) {
+    return lhs.AsVector() < rhs.AsVector();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator>(const CowVector<T, Allocator, GrowthPolicy>& lhs, const CowVector<T, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator<=(const CowVector<T, Allocator, GrowthPolicy>& lhs, const CowVector<T, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator>=(const CowVector<T, Allocator, GrowthPolicy>& lhs, const CowVector<T, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+// Политика роста определяет ёмкость нового буфера, когда в векторе из size элементов
+// не осталось места под ещё один. Результат обязан быть больше size:
+//     template <typename T> static size_t NextCapacity(size_t size) noexcept;
+
+inline constexpr size_t kCacheLineSize = 64;
+
+// Удвоение ёмкости
+struct DoublingGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t size) noexcept {
+        return (size == 0) ? 1 : (2 * size);
+    }
+};
+
+// Рост в полтора раза: сумма освобождённых блоков со временем превышает
+// запрашиваемый размер, и аллокатор может переиспользовать их
+struct OneAndHalfGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t size) noexcept {
+        return (size < 2) ? size + 1 : size + size / 2;
+    }
+};
+
+// Первый буфер занимает хотя бы одну кэш-линию, дальше работает Base
+template <typename Base = DoublingGrowth>
+struct CacheLineMinGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t size) noexcept {
+        constexpr size_t kMinCapacity = std::max<size_t>(1, kCacheLineSize / sizeof(T));
+        return std::max(kMinCapacity, Base::template NextCapacity<T>(size));
+    }
+};
+
+// Округляет ёмкость, выбранную Base, вверх до класса размеров типичного malloc:
+// до 128 байт — шаг 16, дальше четыре класса на каждое удвоение, от страницы — целые страницы.
+// Иначе остаток блока, который аллокатор всё равно выделит, пропадает впустую
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t size) noexcept {
+        const size_t capacity = Base::template NextCapacity<T>(size);
+        if (capacity > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            return capacity;
+        }
+        return std::max(capacity, RoundUpToSizeClass(capacity * sizeof(T)) / sizeof(T));
+    }
+
+    static size_t RoundUpToSizeClass(size_t bytes) noexcept {
+        constexpr size_t kSmallStep = 16;
+        constexpr size_t kSmallLimit = 128;
+        constexpr size_t kPageSize = 4096;
+        if (bytes <= kSmallLimit) {
+            return RoundUp(bytes, kSmallStep);
+        }
+        // Наибольшая степень двойки, меньшая bytes
+        const size_t power = size_t{1} << FloorLog2(bytes - 1);
+        const size_t step = std::max(power / 4, kSmallStep);
+        const size_t rounded = RoundUp(bytes, step);
+        return rounded >= kPageSize ? RoundUp(rounded, kPageSize) : rounded;
+    }
+
+private:
+    static size_t FloorLog2(size_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+#else
+        size_t log = 0;
+        while (value >>= 1) {
+            ++log;
+        }
+        return log;
+#endif
+    }
+
+    // Если округление переполнит size_t, value возвращается как есть:
+    // такой размер всё равно не выделить, и ошибку сообщит аллокатор
+    static size_t RoundUp(size_t value, size_t step) noexcept {
+        if (value > std::numeric_limits<size_t>::max() - (step - 1)) {
+            return value;
+        }
+        return (value + step - 1) / step * step;
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Нетиповая часть HugePageAllocator. Блоки от kHugePageThreshold байт отображаются
+// через mmap на огромные страницы: сначала MAP_HUGETLB (нужны зарезервированные страницы),
+// затем обычное отображение, выровненное по 2 МиБ, с MADV_HUGEPAGE. Если ядро откажет
+// и в этом, память останется на обычных страницах. Меньшие блоки берутся из malloc
+class HugePageAllocatorBase {
+public:
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+    static constexpr size_t kHugePageThreshold = kHugePageSize;
+
+    static bool UsesHugePages(size_t bytes) noexcept {
+#if defined(__linux__)
+        return bytes >= kHugePageThreshold;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+protected:
+    static void* AllocateBytes(size_t bytes) {
+#if defined(__linux__)
+        if (UsesHugePages(bytes)) {
+            return MapHugePages(HugeRound(bytes));
+        }
+#endif
+        void* p = std::malloc(bytes);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    static void DeallocateBytes(void* p, size_t bytes) noexcept {
+#if defined(__linux__)
+        if (UsesHugePages(bytes)) {
+            munmap(p, HugeRound(bytes));
+            return;
+        }
+#endif
+        std::free(p);
+    }
+
+private:
+#if defined(__linux__)
+    static size_t HugeRound(size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    static void* MapHugePages(size_t length) {
+#if defined(MAP_HUGETLB)
+        void* hugetlb = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (hugetlb != MAP_FAILED) {
+            return hugetlb;
+        }
+#endif
+        // Прозрачные огромные страницы покрывают только выровненные по 2 МиБ участки,
+        // поэтому отображаем с запасом и обрезаем края
+        void* raw = mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (aligned != begin) {
+            munmap(raw, aligned - begin);
+        }
+        const size_t tail = kHugePageSize - (aligned - begin);
+        if (tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        void* p = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+        madvise(p, length, MADV_HUGEPAGE);
+#endif
+        return p;
+    }
+#endif
+};
+
+// Аллокатор для больших векторов, которым не хватает TLB: крупные буферы
+// автоматически размещаются на огромных страницах, мелкие — в обычной куче
+template <typename T>
+class HugePageAllocator : public HugePageAllocatorBase {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "HugePageAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(AllocateBytes(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        DeallocateBytes(p, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) noexcept {
+    return false;
+}
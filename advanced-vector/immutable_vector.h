@@ -0,0 +1,1020 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+template <typename T>
+class ImmutableVector;
+
+template <typename T>
+class TransientVector;
+
+namespace immutable_vector_detail {
+
+constexpr size_t kBits = 5;
+constexpr size_t kBranching = size_t{1} << kBits;
+// Сколько узлов сверх минимально возможного числа допускает конкатенация без перебалансировки
+constexpr size_t kConcatExtras = 2;
+
+// Сдвиг индекса к номеру ребёнка в узле высоты height (у листа высота 0)
+constexpr size_t Shift(size_t height) noexcept {
+    return kBits * height;
+}
+
+// Наибольшее число элементов в поддереве высоты height
+constexpr size_t FullSize(size_t height) noexcept {
+    return Shift(height + 1) < std::numeric_limits<size_t>::digits ? size_t{1} << Shift(height + 1)
+                                                                   : std::numeric_limits<size_t>::max();
+}
+
+// Заголовок узла. owner — метка TransientVector, создавшего узел: такой вектор меняет
+// свои узлы на месте. У узлов неизменяемых версий метка нулевая
+template <typename T>
+struct Node {
+    Node(bool is_leaf, uint64_t owner) noexcept
+        : is_leaf(is_leaf)
+        , owner(owner) {
+    }
+
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    std::atomic<uint32_t> refs{1};
+    // Число элементов листа или детей внутреннего узла
+    uint32_t count = 0;
+    bool is_leaf;
+    // Поддерево нельзя обходить по разрядам индекса, нужна таблица размеров
+    bool relaxed = false;
+    uint64_t owner;
+};
+
+template <typename T>
+void Release(Node<T>* node) noexcept;
+
+template <typename T>
+struct Leaf : Node<T> {
+    explicit Leaf(uint64_t owner) noexcept
+        : Node<T>(true, owner) {
+    }
+
+    ~Leaf() {
+        std::destroy_n(Data(), this->count);
+    }
+
+    T* Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    const T* Data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(storage));
+    }
+
+    alignas(T) unsigned char storage[sizeof(T) * kBranching];
+};
+
+// Внутренний узел хранит накопленные размеры детей: по ним ищется ребёнок в
+// ослабленном (relaxed) узле и вычисляется размер поддерева
+template <typename T>
+struct Inner : Node<T> {
+    explicit Inner(uint64_t owner) noexcept
+        : Node<T>(false, owner) {
+    }
+
+    ~Inner() {
+        for (uint32_t i = 0; i < this->count; ++i) {
+            Release(children[i]);
+        }
+    }
+
+    Node<T>* children[kBranching];
+    size_t sizes[kBranching];
+};
+
+template <typename T>
+void AddRef(Node<T>* node) noexcept {
+    node->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+void Release(Node<T>* node) noexcept {
+    if (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (node->is_leaf) {
+            delete static_cast<Leaf<T>*>(node);
+        } else {
+            delete static_cast<Inner<T>*>(node);
+        }
+    }
+}
+
+template <typename T>
+Leaf<T>* AsLeaf(Node<T>* node) noexcept {
+    assert(node->is_leaf);
+    return static_cast<Leaf<T>*>(node);
+}
+
+template <typename T>
+const Leaf<T>* AsLeaf(const Node<T>* node) noexcept {
+    assert(node->is_leaf);
+    return static_cast<const Leaf<T>*>(node);
+}
+
+template <typename T>
+Inner<T>* AsInner(Node<T>* node) noexcept {
+    assert(!node->is_leaf);
+    return static_cast<Inner<T>*>(node);
+}
+
+template <typename T>
+const Inner<T>* AsInner(const Node<T>* node) noexcept {
+    assert(!node->is_leaf);
+    return static_cast<const Inner<T>*>(node);
+}
+
+// Владеющая ссылка на узел со счётчиком ссылок внутри узла
+template <typename T>
+class NodeRef {
+public:
+    NodeRef() noexcept = default;
+
+    // Забирает ссылку, которой уже владеет вызывающий
+    explicit NodeRef(Node<T>* node) noexcept
+        : node_(node) {
+    }
+
+    // Добавляет ещё одну ссылку на node
+    static NodeRef Share(Node<T>* node) noexcept {
+        if (node != nullptr) {
+            AddRef(node);
+        }
+        return NodeRef(node);
+    }
+
+    NodeRef(const NodeRef& other) noexcept
+        : node_(other.node_) {
+        if (node_ != nullptr) {
+            AddRef(node_);
+        }
+    }
+
+    NodeRef(NodeRef&& other) noexcept
+        : node_(std::exchange(other.node_, nullptr)) {
+    }
+
+    NodeRef& operator=(NodeRef rhs) noexcept {
+        std::swap(node_, rhs.node_);
+        return *this;
+    }
+
+    ~NodeRef() {
+        Release(node_);
+    }
+
+    Node<T>* Get() const noexcept {
+        return node_;
+    }
+
+    Node<T>* operator->() const noexcept {
+        return node_;
+    }
+
+    explicit operator bool() const noexcept {
+        return node_ != nullptr;
+    }
+
+    // Отдаёт ссылку вызывающему
+    Node<T>* Detach() noexcept {
+        return std::exchange(node_, nullptr);
+    }
+
+private:
+    Node<T>* node_ = nullptr;
+};
+
+template <typename T>
+size_t SubtreeSize(const Node<T>* node) noexcept {
+    return node->is_leaf ? node->count : AsInner(node)->sizes[node->count - 1];
+}
+
+// Пересчитывает таблицу размеров и признак ослабленности узла высоты height.
+// Узел обходится по разрядам индекса, если все дети, кроме последнего, заполнены
+// полностью, а последний сам обходится по разрядам
+template <typename T>
+void UpdateSizes(Inner<T>* node, size_t height) noexcept {
+    size_t total = 0;
+    bool relaxed = false;
+    for (uint32_t i = 0; i < node->count; ++i) {
+        const Node<T>* child = node->children[i];
+        const size_t child_size = SubtreeSize(child);
+        if (child->relaxed || (i + 1 < node->count && child_size != FullSize(height - 1))) {
+            relaxed = true;
+        }
+        total += child_size;
+        node->sizes[i] = total;
+    }
+    node->relaxed = relaxed;
+}
+
+// Номер ребёнка узла высоты height, содержащего элемент index.
+// index становится смещением элемента внутри ребёнка
+template <typename T>
+size_t ChildIndex(const Inner<T>* node, size_t height, size_t& index) noexcept {
+    size_t slot = index >> Shift(height);
+    if (!node->relaxed) {
+        index -= slot << Shift(height);
+        return slot;
+    }
+    // Ребёнок вмещает не больше FullSize(height - 1) элементов, поэтому разрядная оценка
+    // не превосходит искомый номер
+    while (node->sizes[slot] <= index) {
+        ++slot;
+    }
+    if (slot > 0) {
+        index -= node->sizes[slot - 1];
+    }
+    return slot;
+}
+
+// Лист, содержащий элемент index; index становится смещением в листе
+template <typename T>
+const Leaf<T>* FindLeaf(const Node<T>* node, size_t height, size_t& index) noexcept {
+    for (; height > 0; --height) {
+        const Inner<T>* inner = AsInner(node);
+        node = inner->children[ChildIndex(inner, height, index)];
+    }
+    return AsLeaf(node);
+}
+
+// Узел, который можно менять: сам node, если он принадлежит owner, иначе его копия
+template <typename T>
+NodeRef<T> Editable(Node<T>* node, uint64_t owner) {
+    if (owner != 0 && node->owner == owner) {
+        return NodeRef<T>::Share(node);
+    }
+    if (node->is_leaf) {
+        const Leaf<T>* leaf = AsLeaf(node);
+        NodeRef<T> copy(new Leaf<T>(owner));
+        Leaf<T>* copy_leaf = AsLeaf(copy.Get());
+        for (; copy_leaf->count < leaf->count; ++copy_leaf->count) {
+            new (copy_leaf->Data() + copy_leaf->count) T(leaf->Data()[copy_leaf->count]);
+        }
+        return copy;
+    }
+    const Inner<T>* inner = AsInner(node);
+    Inner<T>* copy = new Inner<T>(owner);
+    for (uint32_t i = 0; i < inner->count; ++i) {
+        AddRef(inner->children[i]);
+        copy->children[i] = inner->children[i];
+        copy->sizes[i] = inner->sizes[i];
+    }
+    copy->count = inner->count;
+    copy->relaxed = inner->relaxed;
+    return NodeRef<T>(copy);
+}
+
+// Заменяет ребёнка slot изменяемого узла
+template <typename T>
+void ReplaceChild(Inner<T>* node, size_t slot, NodeRef<T> child) noexcept {
+    Release(node->children[slot]);
+    node->children[slot] = child.Detach();
+}
+
+// Путь высоты height из одноэлементных узлов, ведущий к листу с value
+template <typename T, typename U>
+NodeRef<T> NewPath(size_t height, U&& value, uint64_t owner) {
+    NodeRef<T> node(new Leaf<T>(owner));
+    new (AsLeaf(node.Get())->Data()) T(std::forward<U>(value));
+    node->count = 1;
+    for (size_t h = 1; h <= height; ++h) {
+        Inner<T>* parent = new Inner<T>(owner);
+        parent->children[0] = node.Detach();
+        parent->sizes[0] = 1;
+        parent->count = 1;
+        node = NodeRef<T>(parent);
+    }
+    return node;
+}
+
+// Есть ли в правом крае поддерева место для ещё одного элемента
+template <typename T>
+bool HasRoom(const Node<T>* node, size_t height) noexcept {
+    for (; height > 0; --height) {
+        if (node->count < kBranching) {
+            return true;
+        }
+        node = AsInner(node)->children[node->count - 1];
+    }
+    return node->count < kBranching;
+}
+
+template <typename T, typename U>
+NodeRef<T> SetIn(Node<T>* node, size_t height, size_t index, U&& value, uint64_t owner) {
+    NodeRef<T> result = Editable(node, owner);
+    if (height == 0) {
+        AsLeaf(result.Get())->Data()[index] = std::forward<U>(value);
+        return result;
+    }
+    Inner<T>* inner = AsInner(result.Get());
+    const size_t slot = ChildIndex(inner, height, index);
+    ReplaceChild(inner, slot, SetIn(inner->children[slot], height - 1, index, std::forward<U>(value), owner));
+    return result;
+}
+
+// Дописывает value в правый край поддерева, в котором есть место (см. HasRoom)
+template <typename T, typename U>
+NodeRef<T> PushIn(Node<T>* node, size_t height, U&& value, uint64_t owner) {
+    NodeRef<T> result = Editable(node, owner);
+    if (height == 0) {
+        Leaf<T>* leaf = AsLeaf(result.Get());
+        new (leaf->Data() + leaf->count) T(std::forward<U>(value));
+        ++leaf->count;
+        return result;
+    }
+    Inner<T>* inner = AsInner(result.Get());
+    const size_t last = inner->count - 1;
+    Node<T>* last_child = inner->children[last];
+    if (HasRoom(last_child, height - 1)) {
+        ReplaceChild(inner, last, PushIn(last_child, height - 1, std::forward<U>(value), owner));
+        ++inner->sizes[last];
+        return result;
+    }
+    inner->children[last + 1] = NewPath<T>(height - 1, std::forward<U>(value), owner).Detach();
+    inner->sizes[last + 1] = inner->sizes[last] + 1;
+    ++inner->count;
+    // Прежний последний ребёнок перестал быть последним и должен быть заполнен полностью
+    const size_t last_size = inner->sizes[last] - (last > 0 ? inner->sizes[last - 1] : 0);
+    if (last_child->relaxed || last_size != FullSize(height - 1)) {
+        inner->relaxed = true;
+    }
+    return result;
+}
+
+// Первые count элементов поддерева, 0 < count <= SubtreeSize(node)
+template <typename T>
+NodeRef<T> TakeFront(Node<T>* node, size_t height, size_t count) {
+    if (count == SubtreeSize(node)) {
+        return NodeRef<T>::Share(node);
+    }
+    if (height == 0) {
+        const Leaf<T>* leaf = AsLeaf(node);
+        NodeRef<T> result(new Leaf<T>(0));
+        Leaf<T>* result_leaf = AsLeaf(result.Get());
+        for (; result_leaf->count < count; ++result_leaf->count) {
+            new (result_leaf->Data() + result_leaf->count) T(leaf->Data()[result_leaf->count]);
+        }
+        return result;
+    }
+    const Inner<T>* inner = AsInner(node);
+    size_t index = count - 1;
+    const size_t slot = ChildIndex(inner, height, index);
+    NodeRef<T> child = TakeFront(inner->children[slot], height - 1, index + 1);
+    Inner<T>* result = new Inner<T>(0);
+    for (size_t i = 0; i < slot; ++i) {
+        AddRef(inner->children[i]);
+        result->children[i] = inner->children[i];
+    }
+    result->children[slot] = child.Detach();
+    result->count = static_cast<uint32_t>(slot + 1);
+    UpdateSizes(result, height);
+    return NodeRef<T>(result);
+}
+
+// Поддерево без первых count элементов, 0 <= count < SubtreeSize(node)
+template <typename T>
+NodeRef<T> DropFront(Node<T>* node, size_t height, size_t count) {
+    if (count == 0) {
+        return NodeRef<T>::Share(node);
+    }
+    if (height == 0) {
+        const Leaf<T>* leaf = AsLeaf(node);
+        NodeRef<T> result(new Leaf<T>(0));
+        Leaf<T>* result_leaf = AsLeaf(result.Get());
+        for (; count + result_leaf->count < leaf->count; ++result_leaf->count) {
+            new (result_leaf->Data() + result_leaf->count) T(leaf->Data()[count + result_leaf->count]);
+        }
+        return result;
+    }
+    const Inner<T>* inner = AsInner(node);
+    size_t index = count;
+    const size_t slot = ChildIndex(inner, height, index);
+    NodeRef<T> child = DropFront(inner->children[slot], height - 1, index);
+    Inner<T>* result = new Inner<T>(0);
+    result->children[0] = child.Detach();
+    for (size_t i = slot + 1; i < inner->count; ++i) {
+        AddRef(inner->children[i]);
+        result->children[i - slot] = inner->children[i];
+    }
+    result->count = static_cast<uint32_t>(inner->count - slot);
+    UpdateSizes(result, height);
+    return NodeRef<T>(result);
+}
+
+// Узлы одной высоты, которые перебалансировка складывает в новый уровень дерева
+template <typename T>
+struct NodeList {
+    // Слева, из середины и справа приходит не больше 2 * kBranching узлов
+    Node<T>* nodes[2 * kBranching];
+    size_t count = 0;
+
+    void Append(const Inner<T>* node, size_t from, size_t to) noexcept {
+        for (size_t i = from; i < to; ++i) {
+            nodes[count++] = node->children[i];
+        }
+    }
+};
+
+// Раскладка содержимого list по узлам при конкатенации (RRB-дерево, Bagwell и Rompf):
+// пока узлов больше, чем минимально возможно плюс kConcatExtras, самый левый
+// недозаполненный узел распределяется по следующим. Возвращает число узлов
+template <typename T>
+size_t CreateConcatPlan(const NodeList<T>& list, size_t* plan) noexcept {
+    size_t total = 0;
+    for (size_t i = 0; i < list.count; ++i) {
+        plan[i] = list.nodes[i]->count;
+        total += plan[i];
+    }
+    const size_t optimal = (total + kBranching - 1) / kBranching;
+    size_t length = list.count;
+    size_t i = 0;
+    while (optimal + kConcatExtras < length) {
+        // Пропускаем узлы, заполненные полностью
+        while (plan[i] == kBranching) {
+            ++i;
+        }
+        size_t remaining = plan[i];
+        do {
+            assert(i + 1 < length);
+            const size_t min_size = std::min(remaining + plan[i + 1], kBranching);
+            plan[i] = min_size;
+            remaining = remaining + plan[i + 1] - min_size;
+            ++i;
+        } while (remaining > 0);
+        for (size_t j = i; j + 1 < length; ++j) {
+            plan[j] = plan[j + 1];
+        }
+        --length;
+        --i;
+    }
+    return length;
+}
+
+// Собирает узлы высоты height по плану. Узел, который уже совпадает с планом, используется повторно
+template <typename T>
+void ExecuteConcatPlan(const NodeList<T>& list, const size_t* plan, size_t plan_length, size_t height,
+                       NodeRef<T>* result) {
+    size_t source = 0;
+    size_t offset = 0;
+    for (size_t n = 0; n < plan_length; ++n) {
+        if (offset == 0 && list.nodes[source]->count == plan[n]) {
+            result[n] = NodeRef<T>::Share(list.nodes[source++]);
+            continue;
+        }
+        if (height == 0) {
+            result[n] = NodeRef<T>(new Leaf<T>(0));
+        } else {
+            result[n] = NodeRef<T>(new Inner<T>(0));
+        }
+        Node<T>* node = result[n].Get();
+        while (node->count < plan[n]) {
+            Node<T>* from = list.nodes[source];
+            const size_t take = std::min<size_t>(plan[n] - node->count, from->count - offset);
+            if (height == 0) {
+                T* dst = AsLeaf(node)->Data();
+                const T* src = AsLeaf(from)->Data() + offset;
+                for (size_t i = 0; i < take; ++i, ++node->count) {
+                    new (dst + node->count) T(src[i]);
+                }
+            } else {
+                Inner<T>* inner = AsInner(node);
+                for (size_t i = 0; i < take; ++i, ++inner->count) {
+                    inner->children[inner->count] = AsInner(from)->children[offset + i];
+                    AddRef(inner->children[inner->count]);
+                }
+            }
+            offset += take;
+            if (offset == from->count) {
+                ++source;
+                offset = 0;
+            }
+        }
+        if (height > 0) {
+            UpdateSizes(AsInner(node), height);
+        }
+    }
+}
+
+template <typename T>
+NodeRef<T> MakeInner(NodeRef<T>* children, size_t count, size_t height) {
+    Inner<T>* node = new Inner<T>(0);
+    for (size_t i = 0; i < count; ++i) {
+        node->children[i] = children[i].Detach();
+    }
+    node->count = static_cast<uint32_t>(count);
+    UpdateSizes(node, height);
+    return NodeRef<T>(node);
+}
+
+// Складывает детей left (кроме последнего), center и right (кроме первого) в узлы
+// высоты height - 1. Вне вершины всегда возвращает обёртку высоты height + 1 из одного
+// или двух узлов; на вершине единственный узел возвращается без обёртки
+template <typename T>
+NodeRef<T> Rebalance(const Inner<T>* left, const Inner<T>* center, const Inner<T>* right, size_t height,
+                     bool is_top, size_t& result_height) {
+    NodeList<T> list;
+    if (left != nullptr) {
+        list.Append(left, 0, left->count - 1);
+    }
+    list.Append(center, 0, center->count);
+    if (right != nullptr) {
+        list.Append(right, 1, right->count);
+    }
+    size_t plan[2 * kBranching];
+    const size_t plan_length = CreateConcatPlan(list, plan);
+    NodeRef<T> nodes[2 * kBranching];
+    ExecuteConcatPlan(list, plan, plan_length, height - 1, nodes);
+
+    NodeRef<T> halves[2];
+    halves[0] = MakeInner(nodes, std::min(plan_length, kBranching), height);
+    if (plan_length <= kBranching && is_top) {
+        result_height = height;
+        return std::move(halves[0]);
+    }
+    size_t halves_count = 1;
+    if (plan_length > kBranching) {
+        halves[1] = MakeInner(nodes + kBranching, plan_length - kBranching, height);
+        halves_count = 2;
+    }
+    result_height = height + 1;
+    return MakeInner(halves, halves_count, height + 1);
+}
+
+template <typename T>
+NodeRef<T> ConcatSubTree(Node<T>* left, size_t left_height, Node<T>* right, size_t right_height, bool is_top,
+                         size_t& result_height) {
+    size_t unused_height = 0;
+    if (left_height > right_height) {
+        const Inner<T>* inner = AsInner(left);
+        NodeRef<T> center = ConcatSubTree(inner->children[inner->count - 1], left_height - 1, right, right_height,
+                                          false, unused_height);
+        return Rebalance(inner, AsInner(center.Get()), static_cast<const Inner<T>*>(nullptr), left_height, is_top,
+                         result_height);
+    }
+    if (left_height < right_height) {
+        const Inner<T>* inner = AsInner(right);
+        NodeRef<T> center = ConcatSubTree(left, left_height, inner->children[0], right_height - 1, false,
+                                          unused_height);
+        return Rebalance(static_cast<const Inner<T>*>(nullptr), AsInner(center.Get()), inner, right_height, is_top,
+                         result_height);
+    }
+    if (left_height == 0) {
+        if (is_top && left->count + right->count <= kBranching) {
+            NodeRef<T> merged = Editable(left, 0);
+            Leaf<T>* leaf = AsLeaf(merged.Get());
+            const Leaf<T>* tail = AsLeaf(right);
+            for (uint32_t i = 0; i < tail->count; ++i, ++leaf->count) {
+                new (leaf->Data() + leaf->count) T(tail->Data()[i]);
+            }
+            result_height = 0;
+            return merged;
+        }
+        NodeRef<T> leaves[2] = {NodeRef<T>::Share(left), NodeRef<T>::Share(right)};
+        result_height = 1;
+        return MakeInner(leaves, 2, 1);
+    }
+    const Inner<T>* left_inner = AsInner(left);
+    const Inner<T>* right_inner = AsInner(right);
+    NodeRef<T> center = ConcatSubTree(left_inner->children[left_inner->count - 1], left_height - 1,
+                                      right_inner->children[0], right_height - 1, false, unused_height);
+    return Rebalance(left_inner, AsInner(center.Get()), right_inner, left_height, is_top, result_height);
+}
+
+// Дерево вектора. Изменяющие методы принимают метку владельца: узлы с этой меткой
+// меняются на месте, остальные копируются по пути от корня
+template <typename T>
+struct Tree {
+    const T& Get(size_t index) const noexcept {
+        assert(index < size);
+        const Leaf<T>* leaf = FindLeaf<T>(root.Get(), height, index);
+        return leaf->Data()[index];
+    }
+
+    // Лист с элементом index, first — индекс первого элемента листа
+    const Leaf<T>* LeafAt(size_t index, size_t& first) const noexcept {
+        size_t offset = index;
+        const Leaf<T>* leaf = FindLeaf<T>(root.Get(), height, offset);
+        first = index - offset;
+        return leaf;
+    }
+
+    template <typename U>
+    void Set(size_t index, U&& value, uint64_t owner) {
+        assert(index < size);
+        root = SetIn(root.Get(), height, index, std::forward<U>(value), owner);
+    }
+
+    template <typename U>
+    void PushBack(U&& value, uint64_t owner) {
+        if (owner != 0 && TryPushInPlace(std::forward<U>(value), owner)) {
+            ++size;
+            return;
+        }
+        if (!root) {
+            root = NewPath<T>(0, std::forward<U>(value), owner);
+        } else if (HasRoom(root.Get(), height)) {
+            root = PushIn(root.Get(), height, std::forward<U>(value), owner);
+        } else {
+            NodeRef<T> children[2] = {root, NewPath<T>(height, std::forward<U>(value), owner)};
+            root = MakeInner(children, 2, height + 1);
+            ++height;
+        }
+        ++size;
+    }
+
+    // Быстрый путь TransientVector: весь правый край принадлежит owner, а в последнем
+    // листе есть место. Обходится без копирования узлов и изменения счётчиков ссылок
+    template <typename U>
+    bool TryPushInPlace(U&& value, uint64_t owner) {
+        if (!root) {
+            return false;
+        }
+        Node<T>* node = root.Get();
+        for (size_t h = height; h > 0; --h) {
+            if (node->owner != owner) {
+                return false;
+            }
+            node = AsInner(node)->children[node->count - 1];
+        }
+        if (node->owner != owner || node->count == kBranching) {
+            return false;
+        }
+        Leaf<T>* leaf = AsLeaf(node);
+        new (leaf->Data() + leaf->count) T(std::forward<U>(value));
+        ++leaf->count;
+        node = root.Get();
+        for (size_t h = height; h > 0; --h) {
+            Inner<T>* inner = AsInner(node);
+            ++inner->sizes[inner->count - 1];
+            node = inner->children[inner->count - 1];
+        }
+        return true;
+    }
+
+    void Concat(const Tree& other) {
+        if (other.size == 0) {
+            return;
+        }
+        if (size == 0) {
+            *this = other;
+            return;
+        }
+        size_t new_height = 0;
+        root = ConcatSubTree(root.Get(), height, other.root.Get(), other.height, true, new_height);
+        height = new_height;
+        size += other.size;
+        CollapseRoot();
+    }
+
+    void Slice(size_t from, size_t to) {
+        assert(from <= to && to <= size);
+        if (from == to) {
+            *this = Tree();
+            return;
+        }
+        root = TakeFront(root.Get(), height, to);
+        root = DropFront(root.Get(), height, from);
+        size = to - from;
+        CollapseRoot();
+    }
+
+    // Убирает корни с единственным ребёнком, оставшиеся после среза или конкатенации
+    void CollapseRoot() noexcept {
+        while (height > 0 && root->count == 1) {
+            root = NodeRef<T>::Share(AsInner(root.Get())->children[0]);
+            --height;
+        }
+    }
+
+    NodeRef<T> root;
+    size_t size = 0;
+    size_t height = 0;
+};
+
+// Итератор произвольного доступа. Помнит текущий лист, поэтому последовательный обход
+// спускается по дереву один раз на kBranching элементов
+template <typename T>
+class Iterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using pointer = const T*;
+
+    Iterator() = default;
+
+    Iterator(const Tree<T>* tree, size_t index) noexcept
+        : tree_(tree)
+        , index_(index) {
+    }
+
+    reference operator*() const noexcept {
+        // При index_ < leaf_first_ разность переполняется и тоже не попадает в лист
+        if (index_ - leaf_first_ >= leaf_size_) {
+            const Leaf<T>* leaf = tree_->LeafAt(index_, leaf_first_);
+            leaf_ = leaf->Data();
+            leaf_size_ = leaf->count;
+        }
+        return leaf_[index_ - leaf_first_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        index_ -= n;
+        return *this;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ != rhs.index_;
+    }
+
+    friend bool operator<(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ < rhs.index_;
+    }
+
+    friend bool operator>(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ > rhs.index_;
+    }
+
+    friend bool operator<=(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ <= rhs.index_;
+    }
+
+    friend bool operator>=(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ >= rhs.index_;
+    }
+
+private:
+    const Tree<T>* tree_ = nullptr;
+    size_t index_ = 0;
+    mutable const T* leaf_ = nullptr;
+    mutable size_t leaf_first_ = 0;
+    mutable size_t leaf_size_ = 0;
+};
+
+// Метки TransientVector уникальны за всё время работы программы: новый вектор
+// не примет узлы уже уничтоженного за свои
+inline uint64_t NextOwner() noexcept {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace immutable_vector_detail
+
+// Неизменяемый вектор на RRB-дереве (relaxed radix balanced tree) с узлами по 32 ребёнка.
+// Set, PushBack, Concat и Slice за O(log32 n) возвращают новую версию, которая разделяет
+// с исходной все незатронутые узлы. Версии можно свободно передавать между потоками.
+// Для серии изменений используйте TransientVector: он меняет собственные узлы на месте
+template <typename T>
+class ImmutableVector {
+    using Tree = immutable_vector_detail::Tree<T>;
+
+public:
+    using value_type = T;
+    using const_iterator = immutable_vector_detail::Iterator<T>;
+    using iterator = const_iterator;
+
+    ImmutableVector() noexcept = default;
+
+    ImmutableVector(std::initializer_list<T> values);
+
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    ImmutableVector(InputIt first, InputIt last);
+
+    size_t Size() const noexcept {
+        return tree_.size;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return tree_.Get(index);
+    }
+
+    // Версия, в которой элемент index заменён на value
+    ImmutableVector Set(size_t index, const T& value) const {
+        return Modified([&](Tree& tree) {
+            tree.Set(index, value, 0);
+        });
+    }
+
+    ImmutableVector Set(size_t index, T&& value) const {
+        return Modified([&](Tree& tree) {
+            tree.Set(index, std::move(value), 0);
+        });
+    }
+
+    // Версия с value в конце
+    ImmutableVector PushBack(const T& value) const {
+        return Modified([&](Tree& tree) {
+            tree.PushBack(value, 0);
+        });
+    }
+
+    ImmutableVector PushBack(T&& value) const {
+        return Modified([&](Tree& tree) {
+            tree.PushBack(std::move(value), 0);
+        });
+    }
+
+    // Версия из элементов этого вектора, за которыми следуют элементы other
+    ImmutableVector Concat(const ImmutableVector& other) const {
+        return Modified([&](Tree& tree) {
+            tree.Concat(other.tree_);
+        });
+    }
+
+    // Версия из элементов [from, to)
+    ImmutableVector Slice(size_t from, size_t to) const {
+        return Modified([&](Tree& tree) {
+            tree.Slice(from, to);
+        });
+    }
+
+    // Изменяемая копия для серии правок. Копирование стоит O(1)
+    TransientVector<T> Transient() const {
+        return TransientVector<T>(*this);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(&tree_, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(&tree_, tree_.size);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    friend class TransientVector<T>;
+
+    explicit ImmutableVector(Tree tree) noexcept
+        : tree_(std::move(tree)) {
+    }
+
+    template <typename Edit>
+    ImmutableVector Modified(Edit edit) const {
+        Tree tree = tree_;
+        edit(tree);
+        return ImmutableVector(std::move(tree));
+    }
+
+    Tree tree_;
+};
+
+// Изменяемый вектор для пакетного построения ImmutableVector. Узлы, созданные им
+// самим, меняются на месте, а разделённые с неизменяемыми версиями копируются при
+// первом изменении. Freeze возвращает неизменяемую версию за O(1)
+template <typename T>
+class TransientVector {
+    using Tree = immutable_vector_detail::Tree<T>;
+
+public:
+    TransientVector()
+        : owner_(immutable_vector_detail::NextOwner()) {
+    }
+
+    explicit TransientVector(const ImmutableVector<T>& base)
+        : tree_(base.tree_)
+        , owner_(immutable_vector_detail::NextOwner()) {
+    }
+
+    TransientVector(const TransientVector&) = delete;
+    TransientVector& operator=(const TransientVector&) = delete;
+    TransientVector(TransientVector&&) noexcept = default;
+    TransientVector& operator=(TransientVector&&) noexcept = default;
+
+    size_t Size() const noexcept {
+        return tree_.size;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return tree_.Get(index);
+    }
+
+    void Set(size_t index, const T& value) {
+        tree_.Set(index, value, owner_);
+    }
+
+    void Set(size_t index, T&& value) {
+        tree_.Set(index, std::move(value), owner_);
+    }
+
+    void PushBack(const T& value) {
+        tree_.PushBack(value, owner_);
+    }
+
+    void PushBack(T&& value) {
+        tree_.PushBack(std::move(value), owner_);
+    }
+
+    // Дописывает в конец элементы other
+    void Append(const ImmutableVector<T>& other) {
+        tree_.Concat(other.tree_);
+    }
+
+    // Неизменяемая версия текущего содержимого. Дальнейшие правки этого вектора
+    // её не затрагивают: узлы получают новую метку владельца и копируются при изменении
+    ImmutableVector<T> Freeze() {
+        owner_ = immutable_vector_detail::NextOwner();
+        return ImmutableVector<T>(tree_);
+    }
+
+    typename ImmutableVector<T>::const_iterator begin() const noexcept {
+        return {&tree_, 0};
+    }
+    typename ImmutableVector<T>::const_iterator end() const noexcept {
+        return {&tree_, tree_.size};
+    }
+
+private:
+    Tree tree_;
+    uint64_t owner_;
+};
+
+template <typename T>
+ImmutableVector<T>::ImmutableVector(std::initializer_list<T> values)
+    : ImmutableVector(values.begin(), values.end()) {
+}
+
+template <typename T>
+template <typename InputIt, typename>
+ImmutableVector<T>::ImmutableVector(InputIt first, InputIt last) {
+    TransientVector<T> builder;
+    for (; first != last; ++first) {
+        builder.PushBack(*first);
+    }
+    *this = builder.Freeze();
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Сколько байт удалось не копировать при росте буферов MallocAllocator
+struct ReallocationStats {
+    // Блок расширен без перемещения (TryExpand)
+    size_t expanded_in_place_bytes = 0;
+    // Блок перенесён перестройкой таблицы страниц (mremap)
+    size_t remapped_bytes = 0;
+    // realloc вернул прежний адрес
+    size_t realloc_in_place_bytes = 0;
+    // Байты, которые всё же пришлось скопировать
+    size_t copied_bytes = 0;
+};
+
+// Нетиповая часть MallocAllocator: работа с байтами и общая статистика.
+// Крупные блоки (от kMmapThreshold байт) выделяются через mmap и растут через mremap,
+// остальные — через malloc/realloc
+class MallocAllocatorBase {
+public:
+    static constexpr size_t kMmapThreshold = size_t{1} << 20;
+
+    static ReallocationStats GetReallocationStats() noexcept {
+        ReallocationStats stats;
+        stats.expanded_in_place_bytes = expanded_in_place_bytes_.load(std::memory_order_relaxed);
+        stats.remapped_bytes = remapped_bytes_.load(std::memory_order_relaxed);
+        stats.realloc_in_place_bytes = realloc_in_place_bytes_.load(std::memory_order_relaxed);
+        stats.copied_bytes = copied_bytes_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    static void ResetReallocationStats() noexcept {
+        expanded_in_place_bytes_.store(0, std::memory_order_relaxed);
+        remapped_bytes_.store(0, std::memory_order_relaxed);
+        realloc_in_place_bytes_.store(0, std::memory_order_relaxed);
+        copied_bytes_.store(0, std::memory_order_relaxed);
+    }
+
+protected:
+    static void* AllocateBytes(size_t bytes) {
+#if defined(__linux__)
+        if (IsMapped(bytes)) {
+            void* p = mmap(nullptr, PageRound(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+#endif
+        void* p = std::malloc(bytes);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    static void DeallocateBytes(void* p, size_t bytes) noexcept {
+#if defined(__linux__)
+        if (IsMapped(bytes)) {
+            munmap(p, PageRound(bytes));
+            return;
+        }
+#endif
+        std::free(p);
+    }
+
+    // Расширяет блок, не меняя его адреса. Блок не может сменить способ выделения,
+    // иначе DeallocateBytes освободит его не тем способом
+    static bool TryExpandBytes(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+#if defined(__linux__)
+        if (IsMapped(old_bytes) != IsMapped(new_bytes)) {
+            return false;
+        }
+        if (IsMapped(new_bytes)) {
+            if (mremap(p, PageRound(old_bytes), PageRound(new_bytes), 0) == MAP_FAILED) {
+                return false;
+            }
+        } else if (malloc_usable_size(p) < new_bytes) {
+            return false;
+        }
+        expanded_in_place_bytes_.fetch_add(old_bytes, std::memory_order_relaxed);
+        return true;
+#else
+        (void)p;
+        (void)old_bytes;
+        (void)new_bytes;
+        return false;
+#endif
+    }
+
+    // Меняет размер блока, перенося его содержимое побайтово
+    static void* ReallocateBytes(void* p, size_t old_bytes, size_t new_bytes) {
+        if (p == nullptr) {
+            return AllocateBytes(new_bytes);
+        }
+        const size_t kept_bytes = std::min(old_bytes, new_bytes);
+#if defined(__linux__)
+        if (IsMapped(old_bytes) && IsMapped(new_bytes)) {
+            void* q = mremap(p, PageRound(old_bytes), PageRound(new_bytes), MREMAP_MAYMOVE);
+            if (q == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            remapped_bytes_.fetch_add(kept_bytes, std::memory_order_relaxed);
+            return q;
+        }
+        if (IsMapped(old_bytes) || IsMapped(new_bytes)) {
+            void* q = AllocateBytes(new_bytes);
+            std::memcpy(q, p, kept_bytes);
+            DeallocateBytes(p, old_bytes);
+            copied_bytes_.fetch_add(kept_bytes, std::memory_order_relaxed);
+            return q;
+        }
+#endif
+        void* q = std::realloc(p, new_bytes);
+        if (q == nullptr) {
+            throw std::bad_alloc();
+        }
+        (q == p ? realloc_in_place_bytes_ : copied_bytes_).fetch_add(kept_bytes, std::memory_order_relaxed);
+        return q;
+    }
+
+private:
+    static bool IsMapped(size_t bytes) noexcept {
+        return bytes >= kMmapThreshold;
+    }
+
+#if defined(__linux__)
+    static size_t PageRound(size_t bytes) noexcept {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page_size - 1) / page_size * page_size;
+    }
+#endif
+
+    static inline std::atomic<size_t> expanded_in_place_bytes_{0};
+    static inline std::atomic<size_t> remapped_bytes_{0};
+    static inline std::atomic<size_t> realloc_in_place_bytes_{0};
+    static inline std::atomic<size_t> copied_bytes_{0};
+};
+
+// Аллокатор поверх malloc/mmap. Кроме стандартного интерфейса предоставляет
+// TryExpand и Reallocate, которыми RawMemory растёт без выделения нового блока
+template <typename T>
+class MallocAllocator : public MallocAllocatorBase {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "MallocAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(AllocateBytes(ToBytes(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        DeallocateBytes(p, n * sizeof(T));
+    }
+
+    bool TryExpand(T* p, size_t old_n, size_t new_n) noexcept {
+        return new_n <= std::numeric_limits<size_t>::max() / sizeof(T)
+            && TryExpandBytes(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    T* Reallocate(T* p, size_t old_n, size_t new_n) {
+        return static_cast<T*>(ReallocateBytes(p, old_n * sizeof(T), ToBytes(new_n)));
+    }
+
+private:
+    static size_t ToBytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const MallocAllocator<T>&, const MallocAllocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const MallocAllocator<T>&, const MallocAllocator<U>&) noexcept {
+    return false;
+}
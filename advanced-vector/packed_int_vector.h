@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+#include "growth_policy.h"
+#include "simd_kernels.h"
+#include "vector.h"
+
+// Сжатый вектор целых без знака. Значения разбиты на блоки по kBlockSize; блок хранит
+// base не больше минимума блока и разности value - base упакованными по width бит, где
+// width — наименьшая ширина, вмещающая разброс значений блока. Блок занимает 2 * width
+// слов, поэтому смещение значения вычисляется без просмотра соседних блоков.
+//
+// PushBack дописывает разность в последний блок. Если значение выходит за диапазон
+// блока, последний блок перепаковывается с новыми base и width; заполненные блоки
+// не меняются. Свободная часть диапазона width оставляется со стороны, куда вышло
+// значение, поэтому монотонные данные перепаковывают блок только при росте width.
+// За данными всегда хранится одно нулевое слово, чтобы распаковка могла читать пару
+// соседних слов без проверки границы
+template <typename Allocator = std::allocator<uint64_t>, typename GrowthPolicy = DoublingGrowth>
+class PackedIntVector {
+    struct Block {
+        uint64_t base;
+        uint64_t offset : 56;
+        uint64_t width : 8;
+    };
+
+    using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+
+public:
+    using allocator_type = Allocator;
+
+    static constexpr size_t kBlockSize = 128;
+    static constexpr size_t kWordBits = 64;
+
+    PackedIntVector() = default;
+
+    explicit PackedIntVector(const Allocator& alloc) noexcept
+        : words_(alloc)
+        , blocks_(BlockAllocator(alloc)) {
+    }
+
+    PackedIntVector(std::initializer_list<uint64_t> values, const Allocator& alloc = Allocator())
+        : PackedIntVector(alloc) {
+        for (uint64_t value : values) {
+            PushBack(value);
+        }
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Байты, занятые блоками и словами с учётом запаса ёмкости
+    size_t MemoryUsage() const noexcept {
+        return blocks_.Capacity() * sizeof(Block) + words_.Capacity() * sizeof(uint64_t);
+    }
+
+    uint64_t Get(size_t index) const noexcept {
+        assert(index < size_);
+        const Block& block = blocks_[index / kBlockSize];
+        if (block.width == 0) {
+            return block.base;
+        }
+        return block.base + Extract(&words_[block.offset], (index % kBlockSize) * block.width, block.width);
+    }
+
+    uint64_t operator[](size_t index) const noexcept {
+        return Get(index);
+    }
+
+    void PushBack(uint64_t value) {
+        const size_t slot = size_ % kBlockSize;
+        if (slot == 0) {
+            blocks_.PushBack(Block{value, DataWords(), 0});
+        } else {
+            Block& block = blocks_[blocks_.Size() - 1];
+            const uint64_t delta = value - block.base;
+            if (value < block.base || delta > Mask(block.width)) {
+                Repack(block, slot, value);
+            } else if (block.width != 0) {
+                Insert(&words_[block.offset], slot * block.width, block.width, delta);
+            }
+        }
+        ++size_;
+    }
+
+    // Распаковывает count значений начиная с first в out. Целые блоки разбираются
+    // SIMD-ядром SimdUnpackBits
+    void Decode(size_t first, size_t count, uint64_t* out) const noexcept {
+        assert(first + count <= size_);
+        while (count > 0) {
+            const Block& block = blocks_[first / kBlockSize];
+            const size_t slot = first % kBlockSize;
+            const size_t n = std::min(count, kBlockSize - slot);
+            SimdUnpackBits(block.width != 0 ? &words_[block.offset] : nullptr, slot, n, block.width, block.base,
+                           out);
+            first += n;
+            count -= n;
+            out += n;
+        }
+    }
+
+    // Все значения в обычном векторе
+    Vector<uint64_t, Allocator> Decode() const {
+        Vector<uint64_t, Allocator> result(size_, kDefaultInit, words_.GetAllocator());
+        Decode(0, size_, result.begin());
+        return result;
+    }
+
+    void ShrinkToFit() {
+        words_.ShrinkToFit();
+        blocks_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        words_.Clear();
+        blocks_.Clear();
+        size_ = 0;
+    }
+
+    void Swap(PackedIntVector& other) noexcept {
+        words_.Swap(other.words_);
+        blocks_.Swap(other.blocks_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    static uint64_t Mask(unsigned width) noexcept {
+        return width == kWordBits ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    }
+
+    static unsigned BitWidth(uint64_t value) noexcept {
+        return value == 0 ? 0 : kWordBits - __builtin_clzll(value);
+    }
+
+    static uint64_t Extract(const uint64_t* words, size_t pos, unsigned width) noexcept {
+        const unsigned shift = pos % kWordBits;
+        uint64_t value = words[pos / kWordBits] >> shift;
+        if (shift + width > kWordBits) {
+            value |= words[pos / kWordBits + 1] << (kWordBits - shift);
+        }
+        return value & Mask(width);
+    }
+
+    // Биты назначения должны быть нулевыми
+    static void Insert(uint64_t* words, size_t pos, unsigned width, uint64_t delta) noexcept {
+        const unsigned shift = pos % kWordBits;
+        words[pos / kWordBits] |= delta << shift;
+        if (shift + width > kWordBits) {
+            words[pos / kWordBits + 1] |= delta >> (kWordBits - shift);
+        }
+    }
+
+    // Слова данных без завершающего нулевого слова
+    size_t DataWords() const noexcept {
+        return words_.Size() == 0 ? 0 : words_.Size() - 1;
+    }
+
+    // Перепаковывает последний блок из count значений так, чтобы в него поместилось value.
+    // Разброс значений блока только растёт, поэтому ширина не уменьшается и слова блока
+    // лишь дописываются в конец. Если value меньше base, base опускается с запасом на
+    // весь остаток диапазона width, иначе base — минимум блока и запас остаётся сверху.
+    // При исключении вектор не меняется
+    void Repack(Block& block, size_t count, uint64_t value) {
+        uint64_t values[kBlockSize];
+        Decode(size_ - count, count, values);
+        values[count] = value;
+        const auto [low, high] = std::minmax_element(values, values + count + 1);
+        const unsigned width = BitWidth(*high - *low);
+        const size_t words = block.offset + 2 * width + 1;
+        if (words > words_.Capacity()) {
+            words_.Reserve(std::max(words, GrowthPolicy::template NextCapacity<uint64_t>(words_.Capacity())));
+        }
+        words_.Resize(words);
+        std::fill(&words_[block.offset], &words_[block.offset] + 2 * width, uint64_t{0});
+        const uint64_t slack = Mask(width) - (*high - *low);
+        block.base = value < block.base ? *low - std::min(*low, slack) : *low;
+        block.width = width;
+        for (size_t i = 0; i <= count; ++i) {
+            Insert(&words_[block.offset], i * width, width, values[i] - block.base);
+        }
+    }
+
+    Vector<uint64_t, Allocator> words_;
+    Vector<Block, BlockAllocator> blocks_;
+    size_t size_ = 0;
+};
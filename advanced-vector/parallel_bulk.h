@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков для массовых операций над большими векторами. Вызывающий поток тоже
+// выполняет задачи. Одновременно пул выполняет одну работу: если он занят или вызов
+// пришёл из задачи пула — в потоке пула или в вызывающем потоке (например, деструктор
+// элемента разрушает вложенный вектор), работа выполняется в вызывающем потоке
+class BulkThreadPool {
+public:
+    explicit BulkThreadPool(size_t threads) {
+        const size_t workers = threads > 1 ? threads - 1 : 0;
+        workers_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back([this] {
+                WorkerLoop();
+            });
+        }
+    }
+
+    BulkThreadPool(const BulkThreadPool&) = delete;
+    BulkThreadPool& operator=(const BulkThreadPool&) = delete;
+
+    ~BulkThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Число потоков вместе с вызывающим
+    size_t ThreadCount() const noexcept {
+        return workers_.size() + 1;
+    }
+
+    // Вызывает task(i) для каждого i из [0, count) и ждёт завершения. task не должна бросать исключений
+    void Run(size_t count, const std::function<void(size_t)>& task) {
+        // Вложенный вызов из задачи не трогает run_mutex_: повторный захват своего мьютекса
+        // (даже через try_lock) — неопределённое поведение
+        if (IsInsideRun() || IsWorkerThread() || workers_.empty()) {
+            RunSerial(count, task);
+            return;
+        }
+        std::unique_lock run_lock(run_mutex_, std::try_to_lock);
+        if (!run_lock.owns_lock()) {
+            RunSerial(count, task);
+            return;
+        }
+        const InsideRunScope inside_run;
+        auto job = std::make_shared<Job>(&task, count);
+        {
+            std::lock_guard lock(mutex_);
+            job_ = job;
+            ++generation_;
+        }
+        wake_.notify_all();
+        Execute(*job);
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [&job] {
+            return job->remaining.load(std::memory_order_acquire) == 0;
+        });
+        job_.reset();
+    }
+
+private:
+    // Работа живёт, пока на неё ссылается хотя бы один поток: опоздавший поток
+    // увидит, что задач не осталось, и не обратится к task
+    struct Job {
+        Job(const std::function<void(size_t)>* task, size_t count)
+            : task(task)
+            , count(count)
+            , remaining(count) {
+        }
+
+        const std::function<void(size_t)>* task;
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> remaining;
+    };
+
+    static bool& IsWorkerThread() noexcept {
+        thread_local bool is_worker = false;
+        return is_worker;
+    }
+
+    // Вызывающий поток выполняет работу пула
+    static bool& IsInsideRun() noexcept {
+        thread_local bool inside_run = false;
+        return inside_run;
+    }
+
+    struct InsideRunScope {
+        InsideRunScope() noexcept {
+            IsInsideRun() = true;
+        }
+        ~InsideRunScope() {
+            IsInsideRun() = false;
+        }
+    };
+
+    static void RunSerial(size_t count, const std::function<void(size_t)>& task) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+    }
+
+    void WorkerLoop() {
+        IsWorkerThread() = true;
+        size_t seen_generation = 0;
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] {
+                    return stop_ || generation_ != seen_generation;
+                });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+                job = job_;
+            }
+            if (job != nullptr) {
+                Execute(*job);
+            }
+        }
+    }
+
+    void Execute(Job& job) {
+        for (size_t i = job.next.fetch_add(1, std::memory_order_relaxed); i < job.count;
+             i = job.next.fetch_add(1, std::memory_order_relaxed)) {
+            (*job.task)(i);
+            if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard lock(mutex_);
+                done_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::shared_ptr<Job> job_;
+    size_t generation_ = 0;
+    bool stop_ = false;
+};
+
+// Параллельный режим массовых операций Vector: конструирования по размеру, копирования,
+// переноса при росте и разрушения. По умолчанию выключен. Включение и выключение
+// не должны пересекаться по времени с операциями над векторами
+class BulkParallelism {
+public:
+    static constexpr size_t kDefaultThresholdBytes = size_t{1} << 24;
+
+    // Операции над диапазонами от threshold_bytes байт делятся между threads потоками
+    static void Enable(size_t threads = std::thread::hardware_concurrency(),
+                       size_t threshold_bytes = kDefaultThresholdBytes) {
+        Pool() = std::make_unique<BulkThreadPool>(std::max<size_t>(threads, 1));
+        Threshold().store(threshold_bytes, std::memory_order_release);
+    }
+
+    static void Disable() {
+        Threshold().store(kDisabled, std::memory_order_release);
+        Pool().reset();
+    }
+
+    static bool ShouldSplit(size_t bytes) noexcept {
+        return bytes >= Threshold().load(std::memory_order_acquire);
+    }
+
+    // Делит [0, n) на части по числу потоков и вызывает body(begin, end) для каждой.
+    // Если какие-то части бросили исключение, для успешно завершённых вызывается
+    // rollback(begin, end), после чего первое исключение перебрасывается. Сама часть,
+    // бросившая исключение, должна откатить свою работу (как std::uninitialized_copy)
+    template <typename Body, typename Rollback>
+    static void ForChunks(size_t n, Body body, Rollback rollback) {
+        BulkThreadPool& pool = *Pool();
+        const size_t chunks = std::max<size_t>(1, std::min(pool.ThreadCount(), n));
+        const auto bounds = [n, chunks](size_t chunk) {
+            return std::pair<size_t, size_t>(n * chunk / chunks, n * (chunk + 1) / chunks);
+        };
+        std::vector<std::exception_ptr> errors(chunks);
+        pool.Run(chunks, [&](size_t chunk) {
+            const auto [begin, end] = bounds(chunk);
+            try {
+                body(begin, end);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        });
+        const auto failed = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& error) {
+            return error != nullptr;
+        });
+        if (failed == errors.end()) {
+            return;
+        }
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (errors[chunk] == nullptr) {
+                const auto [begin, end] = bounds(chunk);
+                rollback(begin, end);
+            }
+        }
+        std::rethrow_exception(*failed);
+    }
+
+    // Вызывает body(begin, end) для частей [0, n), body не бросает исключений.
+    // Если пулу не хватило памяти на запуск, всё выполняется в вызывающем потоке
+    template <typename Body>
+    static void ForChunks(size_t n, Body body) noexcept {
+        try {
+            ForChunks(n, body, [](size_t, size_t) {});
+        } catch (...) {
+            body(0, n);
+        }
+    }
+
+private:
+    static constexpr size_t kDisabled = std::numeric_limits<size_t>::max();
+
+    static std::atomic<size_t>& Threshold() noexcept {
+        static std::atomic<size_t> threshold{kDisabled};
+        return threshold;
+    }
+
+    static std::unique_ptr<BulkThreadPool>& Pool() noexcept {
+        static std::unique_ptr<BulkThreadPool> pool;
+        return pool;
+    }
+};
@@ -0,0 +1,302 @@
+#pragma once
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "growth_policy.h"
+
+// Заголовок в начале файла PersistentVector. Размер вектора хранится прямо в
+// отображённой памяти, поэтому после повторного открытия данные готовы к работе
+struct PersistentVectorHeader {
+    static constexpr uint64_t kMagic = 0x524F544345565650ull;  // "PVVECTOR"
+    static constexpr uint32_t kVersion = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+// Вектор тривиально копируемых элементов, хранящихся в отображённом в память файле.
+// Рост выполняется через ftruncate и mremap, без копирования элементов.
+// Интерфейс повторяет Vector
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class PersistentVector {
+    static_assert(std::is_trivially_copyable_v<T>, "PersistentVector requires trivially copyable T");
+
+public:
+    // Данные начинаются с этого смещения, что задаёт их выравнивание относительно страницы
+    static constexpr size_t kDataOffset = 64;
+
+    static_assert(sizeof(PersistentVectorHeader) <= kDataOffset && alignof(T) <= kDataOffset,
+                  "T is too strictly aligned for PersistentVector");
+
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Открывает файл path или создаёт пустой вектор, если файла нет.
+    // Бросает std::runtime_error, если файл содержит вектор другого типа
+    explicit PersistentVector(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open");
+        }
+        try {
+            Open();
+        } catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    PersistentVector(const PersistentVector&) = delete;
+    PersistentVector& operator=(const PersistentVector&) = delete;
+
+    PersistentVector(PersistentVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , map_(std::exchange(other.map_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0)) {
+    }
+
+    PersistentVector& operator=(PersistentVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            map_ = std::exchange(rhs.map_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+        }
+        return *this;
+    }
+
+    ~PersistentVector() {
+        Close();
+    }
+
+    // Перемещённый вектор пуст
+    size_t Size() const noexcept {
+        return map_ == nullptr ? 0 : static_cast<size_t>(GetHeader().size);
+    }
+
+    size_t Capacity() const noexcept {
+        return map_ == nullptr ? 0 : static_cast<size_t>(GetHeader().capacity);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<PersistentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+    iterator end() noexcept {
+        return Data() + Size();
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+    const_iterator cbegin() const noexcept {
+        return Data();
+    }
+    const_iterator cend() const noexcept {
+        return Data() + Size();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (new_capacity > (std::numeric_limits<size_t>::max() - kDataOffset - page_size) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t new_bytes = (kDataOffset + new_capacity * sizeof(T) + page_size - 1) / page_size * page_size;
+        if (::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+        Remap(new_bytes);
+        // Хвост последней страницы тоже идёт в дело
+        GetHeader().capacity = (new_bytes - kDataOffset) / sizeof(T);
+    }
+
+    void Resize(size_t new_size) {
+        const size_t size = Size();
+        if (new_size > size) {
+            Reserve(new_size);
+            std::memset(static_cast<void*>(Data() + size), 0, (new_size - size) * sizeof(T));
+        }
+        GetHeader().size = new_size;
+    }
+
+    void Clear() noexcept {
+        GetHeader().size = 0;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PopBack() noexcept {
+        assert(Size() > 0);
+        --GetHeader().size;
+    }
+
+    // Элемент создаётся до роста: отображение может переехать, а args — ссылаться на элементы
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const T value(std::forward<Args>(args)...);
+        const size_t size = Size();
+        if (size == Capacity()) {
+            Reserve(GrowthPolicy::template NextCapacity<T>(size));
+        }
+        Data()[size] = value;
+        GetHeader().size = size + 1;
+        return Data()[size];
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        const T value(std::forward<Args>(args)...);
+        const size_t size = Size();
+        if (size == Capacity()) {
+            Reserve(GrowthPolicy::template NextCapacity<T>(size));
+        }
+        T* data = Data();
+        std::memmove(static_cast<void*>(data + index + 1), data + index, (size - index) * sizeof(T));
+        data[index] = value;
+        GetHeader().size = size + 1;
+        return data + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Erase(const_iterator pos) noexcept {
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        const size_t size = Size();
+        T* data = Data();
+        std::memmove(static_cast<void*>(data + index), data + index + 1, (size - index - 1) * sizeof(T));
+        GetHeader().size = size - 1;
+        return data + index;
+    }
+
+    // Синхронно сбрасывает изменения на диск
+    void Sync() {
+        if (::msync(map_, mapped_bytes_, MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+private:
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), std::string("PersistentVector: ") + what);
+    }
+
+    void Open() {
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            ThrowSystemError("fstat");
+        }
+        size_t file_bytes = static_cast<size_t>(st.st_size);
+        const bool created = file_bytes == 0;
+        if (created) {
+            file_bytes = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            if (::ftruncate(fd_, static_cast<off_t>(file_bytes)) != 0) {
+                ThrowSystemError("ftruncate");
+            }
+        } else if (file_bytes < kDataOffset) {
+            throw std::runtime_error("PersistentVector: file is too small");
+        }
+        Remap(file_bytes);
+        PersistentVectorHeader& header = GetHeader();
+        if (created) {
+            header.magic = PersistentVectorHeader::kMagic;
+            header.version = PersistentVectorHeader::kVersion;
+            header.element_size = sizeof(T);
+            header.size = 0;
+            header.capacity = (file_bytes - kDataOffset) / sizeof(T);
+        } else if (header.magic != PersistentVectorHeader::kMagic
+                   || header.version != PersistentVectorHeader::kVersion
+                   || header.element_size != sizeof(T)
+                   || header.size > header.capacity
+                   || header.capacity > (file_bytes - kDataOffset) / sizeof(T)) {
+            throw std::runtime_error("PersistentVector: file holds an incompatible vector");
+        }
+    }
+
+    void Remap(size_t new_bytes) {
+        void* map = MAP_FAILED;
+        if (map_ == nullptr) {
+            map = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        } else {
+#if defined(__linux__)
+            map = ::mremap(map_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+#else
+            map = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (map != MAP_FAILED) {
+                ::munmap(map_, mapped_bytes_);
+            }
+#endif
+        }
+        if (map == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        map_ = map;
+        mapped_bytes_ = new_bytes;
+    }
+
+    void Close() noexcept {
+        if (map_ != nullptr) {
+            ::munmap(map_, mapped_bytes_);
+            map_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    PersistentVectorHeader& GetHeader() noexcept {
+        return *static_cast<PersistentVectorHeader*>(map_);
+    }
+
+    const PersistentVectorHeader& GetHeader() const noexcept {
+        return *static_cast<const PersistentVectorHeader*>(map_);
+    }
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(static_cast<char*>(map_) + kDataOffset);
+    }
+
+    const T* Data() const noexcept {
+        return reinterpret_cast<const T*>(static_cast<const char*>(map_) + kDataOffset);
+    }
+
+    int fd_ = -1;
+    void* map_ = nullptr;
+    size_t mapped_bytes_ = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+// Разбиение индексов на сегменты, каждый следующий из которых вдвое больше предыдущего:
+// сегмент s вмещает 2^(FirstSegmentLog + s) элементов и начинается с индекса
+// 2^FirstSegmentLog * (2^s - 1). Номер сегмента вычисляется одной инструкцией clz
+template <size_t FirstSegmentLog>
+struct SegmentLayout {
+    static constexpr size_t kFirstSegmentSize = size_t{1} << FirstSegmentLog;
+    static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - FirstSegmentLog;
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    static constexpr size_t SegmentStart(size_t segment) noexcept {
+        return SegmentSize(segment) - kFirstSegmentSize;
+    }
+
+    // Номер сегмента и смещение в нём для элемента index
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t segment = FloorLog2((index >> FirstSegmentLog) + 1);
+        return {segment, index - SegmentStart(segment)};
+    }
+
+    static size_t FloorLog2(size_t value) noexcept {
+        assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+#else
+        size_t log = 0;
+        while (value >>= 1) {
+            ++log;
+        }
+        return log;
+#endif
+    }
+};
@@ -0,0 +1,336 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "segment_layout.h"
+#include "vector.h"
+
+// Вектор, который никогда не переносит элементы: память выделяется сегментами, каждый
+// следующий вдвое больше предыдущего. Указатели, ссылки и итераторы на элементы остаются
+// действительными при росте, а индекс переводится в сегмент и смещение за O(1).
+// Интерфейс повторяет Vector, кроме вставки и удаления в середине
+template <typename T>
+class SegmentedVector {
+public:
+    using Layout = SegmentLayout<4>;
+    static constexpr size_t kMaxSegments = Layout::kMaxSegments;
+
+    // Итератор произвольного доступа: внутри сегмента перемещается как указатель
+    template <bool IsConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+            Seek();
+        }
+
+        // Неконстантный итератор приводится к константному
+        operator BasicIterator<true>() const noexcept {
+            return BasicIterator<true>(owner_, index_);
+        }
+
+        reference operator*() const noexcept {
+            return *ptr_;
+        }
+
+        pointer operator->() const noexcept {
+            return ptr_;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            if (++ptr_ == segment_end_) {
+                Seek();
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            Seek();
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --*this;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            Seek();
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            return *this += -offset;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        // Находит ячейку index_ и конец её сегмента. За пределами выделенных сегментов
+        // указатель остаётся пустым: такой итератор можно только сравнивать
+        void Seek() noexcept {
+            const auto [segment, offset] = Layout::Locate(index_);
+            pointer data = owner_->segments_[segment].GetAddress();
+            ptr_ = data != nullptr ? data + offset : nullptr;
+            segment_end_ = data != nullptr ? data + Layout::SegmentSize(segment) : nullptr;
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+        pointer ptr_ = nullptr;
+        pointer segment_end_ = nullptr;
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(size_t size) {
+        Resize(size);
+    }
+
+    SegmentedVector(const SegmentedVector& other) {
+        Reserve(other.size_);
+        try {
+            for (const T& value : other) {
+                EmplaceBack(value);
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept {
+        Swap(other);
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+            segments_[segment].Swap(other.segments_[segment]);
+        }
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        const auto [segment, offset] = Layout::Locate(index);
+        return segments_[segment][offset];
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Выделяет недостающие сегменты. Существующие элементы не переносятся
+    void Reserve(size_t new_capacity) {
+        while (capacity_ < new_capacity) {
+            AddSegment();
+        }
+    }
+
+    // Возвращает память пустых сегментов в конце
+    void ShrinkToFit() noexcept {
+        size_t segments = SegmentCount();
+        while (segments != 0 && Layout::SegmentStart(segments - 1) >= size_) {
+            --segments;
+            segments_[segments] = RawMemory<T>();
+            capacity_ = Layout::SegmentStart(segments);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            const size_t old_size = size_;
+            try {
+                // Сегменты заполняются целиком, без поиска сегмента для каждого элемента
+                while (size_ < new_size) {
+                    const auto [segment, offset] = Layout::Locate(size_);
+                    const size_t count = std::min(Layout::SegmentSize(segment) - offset, new_size - size_);
+                    std::uninitialized_value_construct_n(segments_[segment] + offset, count);
+                    size_ += count;
+                }
+            } catch (...) {
+                DestroyTail(old_size);
+                throw;
+            }
+        } else {
+            DestroyTail(new_size);
+        }
+    }
+
+    void Clear() noexcept {
+        DestroyTail(0);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Элементы не переносятся при росте, поэтому args могут ссылаться на них без временной копии
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            AddSegment();
+        }
+        const auto [segment, offset] = Layout::Locate(size_);
+        T* slot = new (segments_[segment] + offset) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(Slot(size_));
+    }
+
+private:
+    size_t SegmentCount() const noexcept {
+        return capacity_ == 0 ? 0 : Layout::Locate(capacity_ - 1).first + 1;
+    }
+
+    void AddSegment() {
+        const size_t segment = SegmentCount();
+        assert(segment < kMaxSegments);
+        segments_[segment] = RawMemory<T>(Layout::SegmentSize(segment));
+        capacity_ = Layout::SegmentStart(segment + 1);
+    }
+
+    T* Slot(size_t index) noexcept {
+        const auto [segment, offset] = Layout::Locate(index);
+        return segments_[segment] + offset;
+    }
+
+    // Разрушает элементы начиная с new_size, по сегменту за раз
+    void DestroyTail(size_t new_size) noexcept {
+        while (size_ > new_size) {
+            const auto [segment, offset] = Layout::Locate(size_ - 1);
+            const size_t count = std::min(offset + 1, size_ - new_size);
+            std::destroy_n(segments_[segment] + (offset + 1 - count), count);
+            size_ -= count;
+        }
+    }
+
+    RawMemory<T> segments_[kMaxSegments];
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,1097 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ADVANCED_VECTOR_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Поиск, подсчёт, сравнение, минимум, максимум и сумма над непрерывными массивами.
+// Для int32_t, uint32_t, int64_t, uint64_t, float и double используются ядра SSE2, AVX2 или AVX-512,
+// выбранные во время выполнения по cpuid; для остальных типов — обычные алгоритмы.
+// Отдельно — побитовые операции и подсчёт бит над массивами 64-битных слов для BitVector
+// и распаковка значений фиксированной ширины для PackedIntVector.
+// Ядра собираются с атрибутом target, поэтому флаги -mavx2 и подобные не нужны
+
+enum class SimdLevel {
+    kGeneric,
+    kSse2,
+    kAvx2,
+    kAvx512,
+};
+
+// Уровень, доступный процессору и операционной системе
+inline SimdLevel DetectSimdLevel() noexcept {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::kAvx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::kAvx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SimdLevel::kSse2;
+        }
+        return SimdLevel::kGeneric;
+    }();
+    return level;
+#else
+    return SimdLevel::kGeneric;
+#endif
+}
+
+// Ограничивает используемый уровень, например для сравнения ядер в бенчмарке.
+// Уровень выше доступного процессору не включается
+inline std::atomic<SimdLevel>& SimdLevelLimit() noexcept {
+    static std::atomic<SimdLevel> limit{SimdLevel::kAvx512};
+    return limit;
+}
+
+inline SimdLevel ActiveSimdLevel() noexcept {
+    return std::min(DetectSimdLevel(), SimdLevelLimit().load(std::memory_order_relaxed));
+}
+
+// Тип результата Sum: целые суммируются в 64 битах, остальные типы — в самом T
+template <typename T>
+using SimdSumType = std::conditional_t<std::is_integral_v<T>,
+                                       std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, T>;
+
+namespace simd_detail {
+
+// Знаковое целое той же ширины, что и T, если для неё есть ядра (4 или 8 байт), иначе void.
+// Выбор по размеру, а не по имени типа: long и long long одной ширины получают одни ядра
+template <typename T>
+using SameWidthSignedInt =
+    std::conditional_t<sizeof(T) == 4, int32_t, std::conditional_t<sizeof(T) == 8, int64_t, void>>;
+
+template <typename T>
+inline constexpr bool kIsKernelFloat = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Тип, которым ядра равенства обрабатывают T: целые любой знаковости сравниваются побитово
+// как знаковые той же ширины. Для прочих типов ядер нет
+template <typename T>
+using EqualityKernelType = std::conditional_t<std::is_integral_v<T>, SameWidthSignedInt<T>,
+                                              std::conditional_t<kIsKernelFloat<T>, T, void>>;
+
+// Тип, которым ядра Min/Max обрабатывают T. Беззнаковые целые сравниваются знаковыми
+// инструкциями после инверсии старшего бита: она переводит беззнаковый порядок в знаковый
+template <typename T>
+using OrderKernelType = EqualityKernelType<T>;
+
+// Значение T с теми же битами в типе линии K
+template <typename K, typename T>
+K LaneBits(T value) noexcept {
+    static_assert(sizeof(K) == sizeof(T));
+    K lane;
+    std::memcpy(&lane, &value, sizeof(K));
+    return lane;
+}
+
+// Минимум и максимум пропускают NaN: сравнение с NaN ложно, и аккумулятор не меняется
+template <bool IsMin, typename T>
+T ScalarPick(T value, T acc) noexcept {
+    if constexpr (IsMin) {
+        return value < acc ? value : acc;
+    } else {
+        return acc < value ? value : acc;
+    }
+}
+
+// Нейтральный элемент для Min (IsMin) или Max
+template <bool IsMin, typename T>
+constexpr T PickIdentity() noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        return IsMin ? std::numeric_limits<T>::infinity() : -std::numeric_limits<T>::infinity();
+    } else {
+        return IsMin ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+    }
+}
+
+// Число единичных бит без инструкции popcnt: без неё __builtin_popcountll
+// превращается в вызов библиотечной функции
+constexpr size_t PopCount64(uint64_t word) noexcept {
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<size_t>((word * 0x0101010101010101ull) >> 56);
+}
+
+#ifdef ADVANCED_VECTOR_X86_SIMD
+
+// GCC предупреждает о смене ABI для векторных значений внутри обобщённых ядер.
+// Ядра встраиваются только в функции с нужным target, поэтому ABI не затрагивается.
+// Ложное -Wmaybe-uninitialized выдают сами интринсики AVX-512 в GCC 12
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#define ADVANCED_VECTOR_TARGET(isa) __attribute__((target(isa)))
+#define ADVANCED_VECTOR_ALWAYS_INLINE __attribute__((always_inline)) inline
+
+// Операции над регистром для каждого набора инструкций:
+//     Load, Set1, EqMask/NeMask (битовая маска линий), Store;
+//     целочисленный Load читает из памяти любого целого типа той же ширины: загрузка
+//     интринсиком не нарушает strict aliasing, в отличие от разыменования указателя на K;
+//     Pick<IsMin>(value, acc) — покомпонентный минимум или максимум, пропускающий NaN в value;
+//     Xor — у целых с Pick, для беззнакового порядка;
+//     Zero, Add — для сумм чисел с плавающей точкой.
+// kHasPick == false, если у набора нет подходящих инструкций сравнения
+template <typename T>
+struct Sse2Ops;
+
+template <>
+struct Sse2Ops<int32_t> {
+    using Reg = __m128i;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Load(const void* p) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static void Store(int32_t* p, Reg r) noexcept {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Set1(int32_t v) noexcept {
+        return _mm_set1_epi32(v);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return EqMask(a, b) ^ 0xFu;
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm_xor_si128(a, b);
+    }
+    // В SSE2 нет pminsd: выбираем через маску сравнения
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Pick(Reg value, Reg acc) noexcept {
+        const Reg take = IsMin ? _mm_cmpgt_epi32(acc, value) : _mm_cmpgt_epi32(value, acc);
+        return _mm_or_si128(_mm_and_si128(take, value), _mm_andnot_si128(take, acc));
+    }
+};
+
+template <>
+struct Sse2Ops<int64_t> {
+    using Reg = __m128i;
+    static constexpr size_t kLanes = 2;
+    static constexpr bool kHasPick = false;
+
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Load(const void* p) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Set1(int64_t v) noexcept {
+        return _mm_set1_epi64x(v);
+    }
+    // В SSE2 нет pcmpeqq: 64-битные линии равны, если равны обе их 32-битные половины
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        const Reg halves = _mm_cmpeq_epi32(a, b);
+        const Reg both = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(both)));
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return EqMask(a, b) ^ 0x3u;
+    }
+};
+
+template <>
+struct Sse2Ops<float> {
+    using Reg = __m128;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Load(const float* p) noexcept {
+        return _mm_loadu_ps(p);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static void Store(float* p, Reg r) noexcept {
+        _mm_storeu_ps(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Set1(float v) noexcept {
+        return _mm_set1_ps(v);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b)));
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpneq_ps(a, b)));
+    }
+    // minps/maxps возвращают второй операнд, если первый — NaN
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm_min_ps(value, acc) : _mm_max_ps(value, acc);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Zero() noexcept {
+        return _mm_setzero_ps();
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Add(Reg a, Reg b) noexcept {
+        return _mm_add_ps(a, b);
+    }
+};
+
+template <>
+struct Sse2Ops<double> {
+    using Reg = __m128d;
+    static constexpr size_t kLanes = 2;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Load(const double* p) noexcept {
+        return _mm_loadu_pd(p);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static void Store(double* p, Reg r) noexcept {
+        _mm_storeu_pd(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Set1(double v) noexcept {
+        return _mm_set1_pd(v);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpneq_pd(a, b)));
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm_min_pd(value, acc) : _mm_max_pd(value, acc);
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Zero() noexcept {
+        return _mm_setzero_pd();
+    }
+    ADVANCED_VECTOR_TARGET("sse2") static Reg Add(Reg a, Reg b) noexcept {
+        return _mm_add_pd(a, b);
+    }
+};
+
+template <typename T>
+struct Avx2Ops;
+
+template <>
+struct Avx2Ops<int32_t> {
+    using Reg = __m256i;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Load(const void* p) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static void Store(int32_t* p, Reg r) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Set1(int32_t v) noexcept {
+        return _mm256_set1_epi32(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return EqMask(a, b) ^ 0xFFu;
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm256_min_epi32(value, acc) : _mm256_max_epi32(value, acc);
+    }
+};
+
+template <>
+struct Avx2Ops<int64_t> {
+    using Reg = __m256i;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Load(const void* p) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static void Store(int64_t* p, Reg r) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Set1(int64_t v) noexcept {
+        return _mm256_set1_epi64x(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))));
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return EqMask(a, b) ^ 0xFu;
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+    // В AVX2 нет vpminsq: выбираем через маску сравнения
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Pick(Reg value, Reg acc) noexcept {
+        const Reg take = IsMin ? _mm256_cmpgt_epi64(acc, value) : _mm256_cmpgt_epi64(value, acc);
+        return _mm256_blendv_epi8(acc, value, take);
+    }
+};
+
+template <>
+struct Avx2Ops<float> {
+    using Reg = __m256;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Load(const float* p) noexcept {
+        return _mm256_loadu_ps(p);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static void Store(float* p, Reg r) noexcept {
+        _mm256_storeu_ps(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Set1(float v) noexcept {
+        return _mm256_set1_ps(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ)));
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm256_min_ps(value, acc) : _mm256_max_ps(value, acc);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Zero() noexcept {
+        return _mm256_setzero_ps();
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Add(Reg a, Reg b) noexcept {
+        return _mm256_add_ps(a, b);
+    }
+};
+
+template <>
+struct Avx2Ops<double> {
+    using Reg = __m256d;
+    static constexpr size_t kLanes = 4;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Load(const double* p) noexcept {
+        return _mm256_loadu_pd(p);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static void Store(double* p, Reg r) noexcept {
+        _mm256_storeu_pd(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Set1(double v) noexcept {
+        return _mm256_set1_pd(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)));
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm256_min_pd(value, acc) : _mm256_max_pd(value, acc);
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Zero() noexcept {
+        return _mm256_setzero_pd();
+    }
+    ADVANCED_VECTOR_TARGET("avx2") static Reg Add(Reg a, Reg b) noexcept {
+        return _mm256_add_pd(a, b);
+    }
+};
+
+template <typename T>
+struct Avx512Ops;
+
+template <>
+struct Avx512Ops<int32_t> {
+    using Reg = __m512i;
+    static constexpr size_t kLanes = 16;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Load(const void* p) noexcept {
+        return _mm512_loadu_si512(p);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static void Store(int32_t* p, Reg r) noexcept {
+        _mm512_storeu_si512(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Set1(int32_t v) noexcept {
+        return _mm512_set1_epi32(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return _mm512_cmpeq_epi32_mask(a, b);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return _mm512_cmpneq_epi32_mask(a, b);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm512_xor_si512(a, b);
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm512_min_epi32(value, acc) : _mm512_max_epi32(value, acc);
+    }
+};
+
+template <>
+struct Avx512Ops<int64_t> {
+    using Reg = __m512i;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Load(const void* p) noexcept {
+        return _mm512_loadu_si512(p);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static void Store(int64_t* p, Reg r) noexcept {
+        _mm512_storeu_si512(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Set1(int64_t v) noexcept {
+        return _mm512_set1_epi64(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return _mm512_cmpeq_epi64_mask(a, b);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return _mm512_cmpneq_epi64_mask(a, b);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm512_xor_si512(a, b);
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm512_min_epi64(value, acc) : _mm512_max_epi64(value, acc);
+    }
+};
+
+template <>
+struct Avx512Ops<float> {
+    using Reg = __m512;
+    static constexpr size_t kLanes = 16;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Load(const float* p) noexcept {
+        return _mm512_loadu_ps(p);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static void Store(float* p, Reg r) noexcept {
+        _mm512_storeu_ps(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Set1(float v) noexcept {
+        return _mm512_set1_ps(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ);
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm512_min_ps(value, acc) : _mm512_max_ps(value, acc);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Zero() noexcept {
+        return _mm512_setzero_ps();
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Add(Reg a, Reg b) noexcept {
+        return _mm512_add_ps(a, b);
+    }
+};
+
+template <>
+struct Avx512Ops<double> {
+    using Reg = __m512d;
+    static constexpr size_t kLanes = 8;
+    static constexpr bool kHasPick = true;
+
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Load(const double* p) noexcept {
+        return _mm512_loadu_pd(p);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static void Store(double* p, Reg r) noexcept {
+        _mm512_storeu_pd(p, r);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Set1(double v) noexcept {
+        return _mm512_set1_pd(v);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned EqMask(Reg a, Reg b) noexcept {
+        return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static unsigned NeMask(Reg a, Reg b) noexcept {
+        return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ);
+    }
+    template <bool IsMin>
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Pick(Reg value, Reg acc) noexcept {
+        return IsMin ? _mm512_min_pd(value, acc) : _mm512_max_pd(value, acc);
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Zero() noexcept {
+        return _mm512_setzero_pd();
+    }
+    ADVANCED_VECTOR_TARGET("avx512f") static Reg Add(Reg a, Reg b) noexcept {
+        return _mm512_add_pd(a, b);
+    }
+};
+
+// Обобщённые ядра. Они встраиваются в обёртки с атрибутом target ниже, и только там
+// вызовы операций Ops превращаются в инструкции нужного набора. Ядра работают с исходным
+// T: в регистры он попадает через Ops::Load, а хвосты и скалярные циклы читают сами T,
+// поэтому long long, char32_t и подобные не читаются через указатель на другой тип
+
+template <template <typename> typename OpsTemplate, typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE size_t FindKernel(const T* data, size_t n, T value) noexcept {
+    using Ops = OpsTemplate<EqualityKernelType<T>>;
+    const auto needle = Ops::Set1(LaneBits<EqualityKernelType<T>>(value));
+    size_t i = 0;
+    for (; i + Ops::kLanes <= n; i += Ops::kLanes) {
+        if (const unsigned mask = Ops::EqMask(Ops::Load(data + i), needle)) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// Подсчёт компилятор векторизует сам: счётчики совпадений накапливаются в векторном
+// регистре, что быстрее подсчёта бит маски на каждой итерации
+template <typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE size_t CountKernel(const T* data, size_t n, T value) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+template <template <typename> typename OpsTemplate, typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE size_t MismatchKernel(const T* lhs, const T* rhs, size_t n) noexcept {
+    using Ops = OpsTemplate<EqualityKernelType<T>>;
+    size_t i = 0;
+    for (; i + Ops::kLanes <= n; i += Ops::kLanes) {
+        if (const unsigned mask = Ops::NeMask(Ops::Load(lhs + i), Ops::Load(rhs + i))) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < n; ++i) {
+        if (!(lhs[i] == rhs[i])) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <template <typename> typename OpsTemplate, typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE size_t FindNotKernel(const T* data, size_t n, T value) noexcept {
+    using Ops = OpsTemplate<EqualityKernelType<T>>;
+    const auto needle = Ops::Set1(LaneBits<EqualityKernelType<T>>(value));
+    size_t i = 0;
+    for (; i + Ops::kLanes <= n; i += Ops::kLanes) {
+        if (const unsigned mask = Ops::NeMask(Ops::Load(data + i), needle)) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < n; ++i) {
+        if (!(data[i] == value)) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// Беззнаковые линии сравниваются со сдвигом знака: x ^ kSignBit переводит беззнаковый
+// порядок в знаковый, нейтральный элемент T переходит в нейтральный элемент K
+template <template <typename> typename OpsTemplate, bool IsMin, typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE T PickKernel(const T* data, size_t n) noexcept {
+    using K = OrderKernelType<T>;
+    using Ops = OpsTemplate<K>;
+    constexpr bool kFlipSign = std::is_unsigned_v<T>;
+    constexpr K kSignBit = kFlipSign ? std::numeric_limits<K>::lowest() : K{0};
+    auto acc = Ops::Set1(PickIdentity<IsMin, K>());
+    size_t i = 0;
+    for (; i + Ops::kLanes <= n; i += Ops::kLanes) {
+        if constexpr (kFlipSign) {
+            acc = Ops::template Pick<IsMin>(Ops::Xor(Ops::Load(data + i), Ops::Set1(kSignBit)), acc);
+        } else {
+            acc = Ops::template Pick<IsMin>(Ops::Load(data + i), acc);
+        }
+    }
+    K lanes[Ops::kLanes];
+    Ops::Store(lanes, acc);
+    T result = PickIdentity<IsMin, T>();
+    for (K lane : lanes) {
+        if constexpr (kFlipSign) {
+            lane ^= kSignBit;
+        }
+        result = ScalarPick<IsMin>(static_cast<T>(lane), result);
+    }
+    for (; i < n; ++i) {
+        result = ScalarPick<IsMin>(data[i], result);
+    }
+    return result;
+}
+
+// Четыре независимых аккумулятора скрывают задержку сложения
+template <template <typename> typename OpsTemplate, typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE T SumKernel(const T* data, size_t n) noexcept {
+    using Ops = OpsTemplate<T>;
+    constexpr size_t kStep = 4 * Ops::kLanes;
+    auto acc0 = Ops::Zero();
+    auto acc1 = Ops::Zero();
+    auto acc2 = Ops::Zero();
+    auto acc3 = Ops::Zero();
+    size_t i = 0;
+    for (; i + kStep <= n; i += kStep) {
+        acc0 = Ops::Add(acc0, Ops::Load(data + i));
+        acc1 = Ops::Add(acc1, Ops::Load(data + i + Ops::kLanes));
+        acc2 = Ops::Add(acc2, Ops::Load(data + i + 2 * Ops::kLanes));
+        acc3 = Ops::Add(acc3, Ops::Load(data + i + 3 * Ops::kLanes));
+    }
+    for (; i + Ops::kLanes <= n; i += Ops::kLanes) {
+        acc0 = Ops::Add(acc0, Ops::Load(data + i));
+    }
+    T lanes[Ops::kLanes];
+    Ops::Store(lanes, Ops::Add(Ops::Add(acc0, acc1), Ops::Add(acc2, acc3)));
+    T sum = 0;
+    for (T lane : lanes) {
+        sum += lane;
+    }
+    for (; i < n; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Целые суммируются в 64-битном аккумуляторе. Расширение и сложение компилятор векторизует
+// сам под набор инструкций обёртки
+template <typename T>
+ADVANCED_VECTOR_ALWAYS_INLINE SimdSumType<T> IntegerSumKernel(const T* data, size_t n) noexcept {
+    SimdSumType<T> sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Побитовые операции над словами компилятор векторизует сам под набор инструкций обёртки
+template <typename Op>
+ADVANCED_VECTOR_ALWAYS_INLINE void TransformWordsKernel(uint64_t* dst, const uint64_t* lhs, const uint64_t* rhs,
+                                                        size_t n, Op op) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = op(lhs[i], rhs[i]);
+    }
+}
+
+// Точки входа для каждого набора инструкций. T — исходный тип элементов
+#define ADVANCED_VECTOR_SIMD_ENTRY_POINTS(Name, OpsTemplate, isa)                                       \
+    struct Name {                                                                                       \
+        template <typename T>                                                                           \
+        ADVANCED_VECTOR_TARGET(isa) static size_t Find(const T* data, size_t n, T value) noexcept {     \
+            return FindKernel<OpsTemplate>(data, n, value);                                             \
+        }                                                                                               \
+        template <typename T>                                                                           \
+        ADVANCED_VECTOR_TARGET(isa) static size_t Count(const T* data, size_t n, T value) noexcept {    \
+            return CountKernel(data, n, value);                                                         \
+        }                                                                                               \
+        template <typename T>                                                                           \
+        ADVANCED_VECTOR_TARGET(isa) static size_t FindNot(const T* data, size_t n, T value) noexcept {  \
+            return FindNotKernel<OpsTemplate>(data, n, value);                                          \
+        }                                                                                               \
+        template <typename Op>                                                                          \
+        ADVANCED_VECTOR_TARGET(isa) static void TransformWords(uint64_t* dst, const uint64_t* lhs,      \
+                                                               const uint64_t* rhs, size_t n, Op op) noexcept { \
+            TransformWordsKernel(dst, lhs, rhs, n, op);                                                 \
+        }                                                                                               \
+        template <typename T>                                                                           \
+        ADVANCED_VECTOR_TARGET(isa) static size_t Mismatch(const T* lhs, const T* rhs, size_t n) noexcept { \
+            return MismatchKernel<OpsTemplate>(lhs, rhs, n);                                            \
+        }                                                                                               \
+        template <bool IsMin, typename T>                                                               \
+        ADVANCED_VECTOR_TARGET(isa) static T Pick(const T* data, size_t n) noexcept {                   \
+            return PickKernel<OpsTemplate, IsMin>(data, n);                                             \
+        }                                                                                               \
+        template <typename T>                                                                           \
+        ADVANCED_VECTOR_TARGET(isa) static SimdSumType<T> Sum(const T* data, size_t n) noexcept {       \
+            if constexpr (std::is_integral_v<T>) {                                                      \
+                return IntegerSumKernel(data, n);                                                       \
+            } else {                                                                                    \
+                return SumKernel<OpsTemplate>(data, n);                                                 \
+            }                                                                                           \
+        }                                                                                               \
+        template <typename T>                                                                           \
+        static constexpr bool kHasPick = OpsTemplate<OrderKernelType<T>>::kHasPick;                     \
+    };
+
+ADVANCED_VECTOR_SIMD_ENTRY_POINTS(Sse2Kernels, Sse2Ops, "sse2")
+ADVANCED_VECTOR_SIMD_ENTRY_POINTS(Avx2Kernels, Avx2Ops, "avx2")
+ADVANCED_VECTOR_SIMD_ENTRY_POINTS(Avx512Kernels, Avx512Ops, "avx512f")
+
+#undef ADVANCED_VECTOR_SIMD_ENTRY_POINTS
+
+// Подсчёт бит по Муле: число единиц в каждом полубайте берётся из таблицы инструкцией
+// vpshufb, байтовые суммы копятся до 31 итерации и сворачиваются vpsadbw в 64-битные линии
+ADVANCED_VECTOR_TARGET("avx2") inline size_t PopCountAvx2(const uint64_t* words, size_t n) noexcept {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    while (i + 4 <= n) {
+        __m256i bytes = _mm256_setzero_si256();
+        for (size_t step = 0; step < 31 && i + 4 <= n; ++step, i += 4) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+            const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+            bytes = _mm256_add_epi8(bytes, _mm256_add_epi8(low, high));
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    size_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        count += PopCount64(words[i]);
+    }
+    return count;
+}
+
+ADVANCED_VECTOR_TARGET("avx512f,avx512vpopcntdq") inline size_t PopCountAvx512(const uint64_t* words, size_t n) noexcept {
+    __m512i total = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+    }
+    const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(tail, words + i)));
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, total);
+    size_t count = 0;
+    for (uint64_t lane : lanes) {
+        count += lane;
+    }
+    return count;
+}
+
+ADVANCED_VECTOR_TARGET("popcnt") inline size_t PopCountScalar(const uint64_t* words, size_t n) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += static_cast<size_t>(__builtin_popcountll(words[i]));
+    }
+    return count;
+}
+
+// Процессор умеет vpopcntq (AVX-512 VPOPCNTDQ)
+inline bool HasAvx512PopCount() noexcept {
+    static const bool supported = __builtin_cpu_supports("avx512vpopcntdq");
+    return supported;
+}
+
+inline bool HasPopCount() noexcept {
+    static const bool supported = __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+// Распаковка значений ширины width бит: позиции линий растут на kLanes * width за итерацию,
+// пара соседних слов собирается gather, значение склеивается сдвигами с переменным
+// счётчиком. Сдвиг на 64 в vpsllvq даёт ноль, поэтому значения внутри одного слова
+// не требуют отдельной ветки
+ADVANCED_VECTOR_TARGET("avx2") inline size_t UnpackBitsAvx2(const uint64_t* words, size_t first, size_t count,
+                                                            unsigned width, uint64_t base, uint64_t* out) noexcept {
+    const long long* source = reinterpret_cast<const long long*>(words);
+    const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    const __m256i mask_v = _mm256_set1_epi64x(static_cast<long long>(mask));
+    const __m256i base_v = _mm256_set1_epi64x(static_cast<long long>(base));
+    const __m256i bits_v = _mm256_set1_epi64x(64);
+    const __m256i step = _mm256_set1_epi64x(static_cast<long long>(4 * width));
+    __m256i pos = _mm256_setr_epi64x(static_cast<long long>(first * width), static_cast<long long>((first + 1) * width),
+                                     static_cast<long long>((first + 2) * width),
+                                     static_cast<long long>((first + 3) * width));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i index = _mm256_srli_epi64(pos, 6);
+        const __m256i shift = _mm256_and_si256(pos, _mm256_set1_epi64x(63));
+        const __m256i low = _mm256_i64gather_epi64(source, index, 8);
+        const __m256i high = _mm256_i64gather_epi64(source + 1, index, 8);
+        const __m256i value = _mm256_or_si256(_mm256_srlv_epi64(low, shift),
+                                              _mm256_sllv_epi64(high, _mm256_sub_epi64(bits_v, shift)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_add_epi64(_mm256_and_si256(value, mask_v), base_v));
+        pos = _mm256_add_epi64(pos, step);
+    }
+    return i;
+}
+
+ADVANCED_VECTOR_TARGET("avx512f") inline size_t UnpackBitsAvx512(const uint64_t* words, size_t first, size_t count,
+                                                                 unsigned width, uint64_t base, uint64_t* out) noexcept {
+    const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    const __m512i mask_v = _mm512_set1_epi64(static_cast<long long>(mask));
+    const __m512i base_v = _mm512_set1_epi64(static_cast<long long>(base));
+    const __m512i bits_v = _mm512_set1_epi64(64);
+    const __m512i step = _mm512_set1_epi64(static_cast<long long>(8 * width));
+    const long long start = static_cast<long long>(first * width);
+    const long long w = width;
+    __m512i pos = _mm512_setr_epi64(start, start + w, start + 2 * w, start + 3 * w, start + 4 * w, start + 5 * w,
+                                    start + 6 * w, start + 7 * w);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512i index = _mm512_srli_epi64(pos, 6);
+        const __m512i shift = _mm512_and_si512(pos, _mm512_set1_epi64(63));
+        const __m512i low = _mm512_i64gather_epi64(index, words, 8);
+        const __m512i high = _mm512_i64gather_epi64(index, words + 1, 8);
+        const __m512i value = _mm512_or_si512(_mm512_srlv_epi64(low, shift),
+                                              _mm512_sllv_epi64(high, _mm512_sub_epi64(bits_v, shift)));
+        _mm512_storeu_si512(out + i, _mm512_add_epi64(_mm512_and_si512(value, mask_v), base_v));
+        pos = _mm512_add_epi64(pos, step);
+    }
+    return i;
+}
+#undef ADVANCED_VECTOR_ALWAYS_INLINE
+#undef ADVANCED_VECTOR_TARGET
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Вызывает call(Kernels) для активного набора инструкций; false, если SIMD недоступен
+template <typename Call>
+bool DispatchSimd(Call call) {
+    switch (ActiveSimdLevel()) {
+        case SimdLevel::kAvx512:
+            call(Avx512Kernels{});
+            return true;
+        case SimdLevel::kAvx2:
+            call(Avx2Kernels{});
+            return true;
+        case SimdLevel::kSse2:
+            call(Sse2Kernels{});
+            return true;
+        case SimdLevel::kGeneric:
+            break;
+    }
+    return false;
+}
+
+#endif  // ADVANCED_VECTOR_X86_SIMD
+
+// Поиск NaN-свободного результата Min/Max: если ни одно значение не заменило нейтральный
+// элемент, массив состоит из NaN и самого нейтрального элемента
+template <bool IsMin, typename T>
+T FinishPick(const T* data, size_t n, T result) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (result == PickIdentity<IsMin, T>() && std::find(data, data + n, result) == data + n) {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+    }
+    return result;
+}
+
+template <bool IsMin, typename T>
+T SimdPick(const T* data, size_t n) {
+    using K = OrderKernelType<T>;
+    T result = PickIdentity<IsMin, T>();
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    if constexpr (!std::is_void_v<K>) {
+        const bool done = DispatchSimd([&](auto kernels) {
+            using Kernels = decltype(kernels);
+            if constexpr (Kernels::template kHasPick<T>) {
+                result = Kernels::template Pick<IsMin>(data, n);
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    result = ScalarPick<IsMin>(data[i], result);
+                }
+            }
+        });
+        if (done) {
+            return FinishPick<IsMin>(data, n, result);
+        }
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        result = ScalarPick<IsMin>(data[i], result);
+    }
+    return FinishPick<IsMin>(data, n, result);
+}
+
+}  // namespace simd_detail
+
+// Индекс первого элемента, равного value, или n
+template <typename T>
+size_t SimdFind(const T* data, size_t n, const T& value) {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    using K = simd_detail::EqualityKernelType<T>;
+    if constexpr (!std::is_void_v<K>) {
+        size_t index = n;
+        if (simd_detail::DispatchSimd([&](auto kernels) {
+                index = decltype(kernels)::Find(data, n, value);
+            })) {
+            return index;
+        }
+    }
+#endif
+    return static_cast<size_t>(std::find(data, data + n, value) - data);
+}
+
+// Число элементов, равных value
+template <typename T>
+size_t SimdCount(const T* data, size_t n, const T& value) {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    using K = simd_detail::EqualityKernelType<T>;
+    if constexpr (!std::is_void_v<K>) {
+        size_t count = 0;
+        if (simd_detail::DispatchSimd([&](auto kernels) {
+                count = decltype(kernels)::Count(data, n, value);
+            })) {
+            return count;
+        }
+    }
+#endif
+    return static_cast<size_t>(std::count(data, data + n, value));
+}
+
+// Индекс первой позиции, где !(lhs[i] == rhs[i]), или n
+template <typename T>
+size_t SimdMismatch(const T* lhs, const T* rhs, size_t n) {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    using K = simd_detail::EqualityKernelType<T>;
+    if constexpr (!std::is_void_v<K>) {
+        size_t index = n;
+        if (simd_detail::DispatchSimd([&](auto kernels) {
+                index = decltype(kernels)::Mismatch(lhs, rhs, n);
+            })) {
+            return index;
+        }
+    }
+#endif
+    return static_cast<size_t>(std::mismatch(lhs, lhs + n, rhs).first - lhs);
+}
+
+// Минимум арифметических значений; NaN пропускаются, а если других значений нет, результат — NaN
+template <typename T>
+T SimdMin(const T* data, size_t n) {
+    return simd_detail::SimdPick<true>(data, n);
+}
+
+template <typename T>
+T SimdMax(const T* data, size_t n) {
+    return simd_detail::SimdPick<false>(data, n);
+}
+
+// Сумма арифметических значений; целые суммируются в 64 битах.
+// Для float и double порядок сложения не задан
+template <typename T>
+SimdSumType<T> SimdSum(const T* data, size_t n) {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    if constexpr (std::is_integral_v<T> || simd_detail::kIsKernelFloat<T>) {
+        SimdSumType<T> sum = 0;
+        if (simd_detail::DispatchSimd([&](auto kernels) {
+                sum = decltype(kernels)::Sum(data, n);
+            })) {
+            return sum;
+        }
+    }
+#endif
+    SimdSumType<T> sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Индекс первого элемента, не равного value, или n
+template <typename T>
+size_t SimdFindNot(const T* data, size_t n, const T& value) {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    using K = simd_detail::EqualityKernelType<T>;
+    if constexpr (!std::is_void_v<K>) {
+        size_t index = n;
+        if (simd_detail::DispatchSimd([&](auto kernels) {
+                index = decltype(kernels)::FindNot(data, n, value);
+            })) {
+            return index;
+        }
+    }
+#endif
+    return static_cast<size_t>(std::find_if(data, data + n, [&value](const T& element) {
+                                    return !(element == value);
+                                }) - data);
+}
+
+// dst[i] = op(lhs[i], rhs[i]) для n слов. dst может совпадать с lhs или rhs.
+// op должна быть простой побитовой операцией, которую компилятор векторизует
+template <typename Op>
+void SimdTransformWords(uint64_t* dst, const uint64_t* lhs, const uint64_t* rhs, size_t n, Op op) noexcept {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    if (simd_detail::DispatchSimd([&](auto kernels) {
+            decltype(kernels)::TransformWords(dst, lhs, rhs, n, op);
+        })) {
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = op(lhs[i], rhs[i]);
+    }
+}
+
+// Число единичных бит в n словах: vpopcntq на AVX-512, таблица полубайтов на AVX2,
+// popcnt на SSE2
+inline size_t SimdPopCount(const uint64_t* words, size_t n) noexcept {
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    switch (ActiveSimdLevel()) {
+        case SimdLevel::kAvx512:
+            if (simd_detail::HasAvx512PopCount()) {
+                return simd_detail::PopCountAvx512(words, n);
+            }
+            return simd_detail::PopCountAvx2(words, n);
+        case SimdLevel::kAvx2:
+            return simd_detail::PopCountAvx2(words, n);
+        case SimdLevel::kSse2:
+            if (simd_detail::HasPopCount()) {
+                return simd_detail::PopCountScalar(words, n);
+            }
+            break;
+        case SimdLevel::kGeneric:
+            break;
+    }
+#endif
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += simd_detail::PopCount64(words[i]);
+    }
+    return count;
+}
+
+// out[i] = base + значение ширины width бит с номером first + i в плотно упакованном
+// массиве words, i < count. Значение номер k занимает биты [k * width, (k + 1) * width).
+// За упакованными данными должно быть доступно для чтения ещё одно слово
+inline void SimdUnpackBits(const uint64_t* words, size_t first, size_t count, unsigned width, uint64_t base,
+                           uint64_t* out) noexcept {
+    if (width == 0) {
+        std::fill_n(out, count, base);
+        return;
+    }
+    size_t done = 0;
+#ifdef ADVANCED_VECTOR_X86_SIMD
+    switch (ActiveSimdLevel()) {
+        case SimdLevel::kAvx512:
+            done = simd_detail::UnpackBitsAvx512(words, first, count, width, base, out);
+            break;
+        case SimdLevel::kAvx2:
+            done = simd_detail::UnpackBitsAvx2(words, first, count, width, base, out);
+            break;
+        case SimdLevel::kSse2:
+        case SimdLevel::kGeneric:
+            break;
+    }
+#endif
+    const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    for (size_t i = done; i < count; ++i) {
+        const size_t pos = (first + i) * width;
+        const unsigned shift = pos % 64;
+        uint64_t value = words[pos / 64] >> shift;
+        if (shift != 0) {
+            value |= words[pos / 64 + 1] << (64 - shift);
+        }
+        out[i] = base + (value & mask);
+    }
+}
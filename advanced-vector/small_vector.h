@@ -0,0 +1,281 @@
+#pragma once
+#include "vector.h"
+
+// Вектор, хранящий первые N элементов внутри себя. Куча задействуется,
+// только когда элементов становится больше N. Пока heap_ пуст, вектор
+// находится во встроенном состоянии
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static_assert(N > 0, "SmallVector needs inline capacity");
+
+public:
+    using allocator_type = Allocator;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Allocator& alloc) noexcept
+        : heap_(alloc) {
+    }
+
+    explicit SmallVector(size_t size, const Allocator& alloc = Allocator())
+        : heap_(alloc) {
+        Resize(size);
+    }
+
+    SmallVector(const SmallVector& other)
+        : SmallVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    SmallVector(const SmallVector& other, const Allocator& alloc)
+        : heap_(alloc) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(other.GetAllocator()) {
+        if (other.IsInline()) {
+            std::uninitialized_move_n(other.Data(), other.size_, Data());
+            size_ = other.size_;
+            other.Clear();
+        } else {
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+        }
+    }
+
+    ~SmallVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Буфер в куче принадлежит старому аллокатору
+                    Clear();
+                    heap_.Reset(rhs.GetAllocator());
+                } else {
+                    heap_.SetAllocator(rhs.GetAllocator());
+                }
+            }
+            SmallVector rhs_copy(rhs, GetAllocator());
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                       && (AllocTraits::propagate_on_container_move_assignment::value
+                                                           || AllocTraits::is_always_equal::value)) {
+        if (this != &rhs) {
+            Clear();
+            if (!rhs.IsInline() && (AllocTraits::propagate_on_container_move_assignment::value
+                                    || GetAllocator() == rhs.GetAllocator())) {
+                heap_ = std::move(rhs.heap_);
+                size_ = std::exchange(rhs.size_, 0);
+            } else {
+                // Встроенные элементы (или элементы чужого аллокатора) переносятся поштучно
+                Reserve(rhs.size_);
+                std::uninitialized_move_n(rhs.Data(), rhs.size_, Data());
+                size_ = rhs.size_;
+                rhs.Clear();
+            }
+        }
+        return *this;
+    }
+
+    // Обмен встроенными элементами требует их поэлементного перемещения
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+        if (this == &other) {
+            return;
+        }
+        if (!IsInline() && !other.IsInline()) {
+            heap_.Swap(other.heap_);
+        } else if (IsInline() && other.IsInline()) {
+            SmallVector& shorter = size_ < other.size_ ? *this : other;
+            SmallVector& longer = size_ < other.size_ ? other : *this;
+            std::swap_ranges(shorter.Data(), shorter.Data() + shorter.size_, longer.Data());
+            std::uninitialized_move(longer.Data() + shorter.size_, longer.Data() + longer.size_,
+                                    shorter.Data() + shorter.size_);
+            std::destroy(longer.Data() + shorter.size_, longer.Data() + longer.size_);
+        } else {
+            SmallVector& in_place = IsInline() ? *this : other;
+            SmallVector& on_heap = IsInline() ? other : *this;
+            // Встроенное хранилище вектора из кучи свободно: переносим туда элементы
+            std::uninitialized_move_n(in_place.InlineData(), in_place.size_, on_heap.InlineData());
+            std::destroy_n(in_place.InlineData(), in_place.size_);
+            heap_.Swap(other.heap_);
+        }
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Элементы хранятся внутри объекта, а не в куче
+    bool IsInline() const noexcept {
+        return heap_.Capacity() == 0;
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+    const_iterator cbegin() const noexcept {
+        return Data();
+    }
+    const_iterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+        UninitializedRelocateN(Data(), size_, new_data.GetAddress());
+        heap_.Swap(new_data);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+        } else {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(Data() + size_);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ < Capacity()) {
+            new (Data() + size_) T(std::forward<Args>(args)...);
+        } else {
+            EmplaceWithReallocation(size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Data()[size_ - 1];
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        if (pos == cend()) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return Data() + index;
+        }
+        if (size_ < Capacity()) {
+            T value(std::forward<Args>(args)...);
+            T* data = Data();
+            std::uninitialized_move(data + size_ - 1, data + size_, data + size_);
+            std::move_backward(data + index, data + size_ - 1, data + size_);
+            data[index] = std::move(value);
+        } else {
+            EmplaceWithReallocation(index, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Data() + index;
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        T* data = Data();
+        std::move(data + index + 1, data + size_, data + index);
+        std::destroy_at(data + size_ - 1);
+        --size_;
+        return data + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+private:
+    T* InlineData() noexcept {
+        return std::launder(reinterpret_cast<T*>(inline_));
+    }
+
+    const T* InlineData() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(inline_));
+    }
+
+    T* Data() noexcept {
+        return IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    // Элемент создаётся в новом буфере до переноса остальных, так как args могут ссылаться на них
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t pos, Args&&... args) {
+        const size_t new_capacity = std::max(GrowthPolicy::template NextCapacity<T>(size_), N + 1);
+        RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+        new (new_data + pos) T(std::forward<Args>(args)...);
+        try {
+            UninitializedRelocateN(Data(), size_, new_data.GetAddress(), pos, 1);
+        } catch (...) {
+            std::destroy_at(new_data + pos);
+            throw;
+        }
+        heap_.Swap(new_data);
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    RawMemory<T, Allocator> heap_;
+    size_t size_ = 0;
+};
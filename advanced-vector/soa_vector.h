@@ -0,0 +1,527 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Непрерывный диапазон элементов одного столбца SoAVector
+template <typename T>
+class ColumnSpan {
+public:
+    ColumnSpan(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+// Вектор записей из полей Ts..., в котором каждое поле хранится в своём буфере RawMemory
+// (структура массивов). Буферы растут одновременно по GrowthPolicy, как у Vector, поэтому
+// обход одного поля читает только его данные. Allocator перепривязывается к типу каждого
+// столбца. Строки доступны через прокси Row. Обычно используется через псевдоним SoAVector
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+class BasicSoAVector {
+    static_assert(sizeof...(Ts) > 0, "SoAVector requires at least one column");
+
+    template <typename T>
+    using ColumnAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Storage = std::tuple<RawMemory<Ts, ColumnAllocator<Ts>>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+    // Сдвиг элементов внутри буфера не бросает исключений, и вставка может обойтись без нового буфера
+    static constexpr bool kNothrowShift = (std::is_nothrow_move_constructible_v<Ts> && ...)
+                                          && (std::is_nothrow_move_assignable_v<Ts> && ...);
+
+public:
+    static constexpr size_t kColumnCount = sizeof...(Ts);
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    // Ссылка на строку: поля доступны через Get<I>() или все сразу через Tie()
+    template <bool IsConst>
+    class BasicRow {
+        using Owner = std::conditional_t<IsConst, const BasicSoAVector, BasicSoAVector>;
+
+    public:
+        BasicRow(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        template <size_t I>
+        auto& Get() const noexcept {
+            return owner_->template Data<I>()[index_];
+        }
+
+        auto Tie() const noexcept {
+            return TieImpl(Indices{});
+        }
+
+        // Копия значений строки
+        operator std::tuple<Ts...>() const {
+            return Tie();
+        }
+
+        size_t Index() const noexcept {
+            return index_;
+        }
+
+    private:
+        template <size_t... Is>
+        auto TieImpl(std::index_sequence<Is...>) const noexcept {
+            return std::tie(Get<Is>()...);
+        }
+
+        Owner* owner_;
+        size_t index_;
+    };
+
+    using Row = BasicRow<false>;
+    using ConstRow = BasicRow<true>;
+
+    // Итератор по строкам. Разыменование возвращает прокси по значению
+    template <bool IsConst>
+    class BasicRowIterator {
+        using Owner = std::conditional_t<IsConst, const BasicSoAVector, BasicSoAVector>;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = BasicRow<IsConst>;
+        using pointer = void;
+
+        BasicRowIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        reference operator*() const noexcept {
+            return reference(owner_, index_);
+        }
+
+        BasicRowIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicRowIterator operator++(int) noexcept {
+            BasicRowIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        bool operator==(const BasicRowIterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const BasicRowIterator& other) const noexcept {
+            return index_ != other.index_;
+        }
+
+    private:
+        Owner* owner_;
+        size_t index_;
+    };
+
+    using iterator = BasicRowIterator<false>;
+    using const_iterator = BasicRowIterator<true>;
+
+    BasicSoAVector() = default;
+
+    explicit BasicSoAVector(const Allocator& alloc) noexcept
+        : data_(MakeStorage(0, alloc)) {
+    }
+
+    explicit BasicSoAVector(size_t size, const Allocator& alloc = Allocator())
+        : data_(MakeStorage(size, alloc)) {
+        ConstructColumns(data_, 0, size, [](auto, auto* dst, size_t n) {
+            std::uninitialized_value_construct_n(dst, n);
+        });
+        size_ = size;
+    }
+
+    BasicSoAVector(const BasicSoAVector& other)
+        : BasicSoAVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    BasicSoAVector(const BasicSoAVector& other, const Allocator& alloc)
+        : data_(MakeStorage(other.size_, alloc)) {
+        ConstructColumns(data_, 0, other.size_, [&other](auto column, auto* dst, size_t n) {
+            std::uninitialized_copy_n(other.template Data<decltype(column)::value>(), n, dst);
+        });
+        size_ = other.size_;
+    }
+
+    BasicSoAVector(BasicSoAVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    BasicSoAVector& operator=(const BasicSoAVector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Буферы принадлежат старому аллокатору
+                    Clear();
+                    ResetStorage(rhs.GetAllocator(), Indices{});
+                } else {
+                    SetStorageAllocator(rhs.GetAllocator(), Indices{});
+                }
+            }
+            BasicSoAVector rhs_copy(rhs, GetAllocator());
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    BasicSoAVector& operator=(BasicSoAVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                             || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (AllocTraits::propagate_on_container_move_assignment::value || GetAllocator() == rhs.GetAllocator()) {
+                Clear();
+                data_ = std::move(rhs.data_);
+                size_ = std::exchange(rhs.size_, 0);
+            } else {
+                // Чужие буферы забрать нельзя: перемещаем элементы в память своего аллокатора
+                Storage new_data = MakeStorage(rhs.size_, GetAllocator());
+                ConstructColumns(new_data, 0, rhs.size_, [&rhs](auto column, auto* dst, size_t n) {
+                    std::uninitialized_move_n(rhs.template Data<decltype(column)::value>(), n, dst);
+                });
+                Clear();
+                SwapStorage(data_, new_data, Indices{});
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+
+    ~BasicSoAVector() {
+        Clear();
+    }
+
+    // Аллокатор столбцов, перепривязанный обратно к Allocator
+    Allocator GetAllocator() const noexcept {
+        return Allocator(std::get<0>(data_).GetAllocator());
+    }
+
+    void Swap(BasicSoAVector& other) noexcept {
+        SwapStorage(data_, other.data_, Indices{});
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(data_).Capacity();
+    }
+
+    // Указатель на начало столбца I
+    template <size_t I>
+    ColumnType<I>* Data() noexcept {
+        return std::get<I>(data_).GetAddress();
+    }
+
+    template <size_t I>
+    const ColumnType<I>* Data() const noexcept {
+        return std::get<I>(data_).GetAddress();
+    }
+
+    // Столбец I целиком
+    template <size_t I>
+    ColumnSpan<ColumnType<I>> Column() noexcept {
+        return ColumnSpan<ColumnType<I>>(Data<I>(), size_);
+    }
+
+    template <size_t I>
+    ColumnSpan<const ColumnType<I>> Column() const noexcept {
+        return ColumnSpan<const ColumnType<I>>(Data<I>(), size_);
+    }
+
+    Row operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(this, index);
+    }
+
+    ConstRow operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return ConstRow(this, index);
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        Storage new_data = MakeStorage(new_capacity, GetAllocator());
+        RelocateTo(new_data);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            ConstructColumns(data_, size_, new_size - size_, [](auto, auto* dst, size_t n) {
+                std::uninitialized_value_construct_n(dst, n);
+            });
+        } else {
+            DestroyRows(data_, new_size, size_ - new_size, Indices{});
+        }
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        DestroyRows(data_, 0, size_, Indices{});
+        size_ = 0;
+    }
+
+    void PushBack(const Ts&... values) {
+        EmplaceBack(values...);
+    }
+
+    void PushBack(Ts&&... values) {
+        EmplaceBack(std::move(values)...);
+    }
+
+    // Дописывает строку, поле I которой конструируется из аргумента args[I]
+    template <typename... Args>
+    Row EmplaceBack(Args&&... args) {
+        return Emplace(size_, std::forward<Args>(args)...);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        DestroyRows(data_, size_ - 1, 1, Indices{});
+        --size_;
+    }
+
+    // Вставляет строку перед строкой index. Если сдвиг элементов может бросить исключение,
+    // строки переносятся в новый буфер, и при ошибке вектор не меняется
+    template <typename... Args>
+    Row Emplace(size_t index, Args&&... args) {
+        static_assert(sizeof...(Args) == kColumnCount, "Emplace takes one argument per column");
+        assert(index <= size_);
+        if (size_ == Capacity() || (index != size_ && !kNothrowShift)) {
+            const size_t new_capacity = size_ == Capacity()
+                ? GrowthPolicy::template NextCapacity<std::tuple<Ts...>>(size_)
+                : Capacity();
+            Storage new_data = MakeStorage(new_capacity, GetAllocator());
+            // Строка создаётся до переноса, так как args могут ссылаться на элементы вектора
+            EmplaceColumns(new_data, index, std::forward_as_tuple(std::forward<Args>(args)...));
+            try {
+                RelocateTo(new_data, index, 1);
+            } catch (...) {
+                DestroyRows(new_data, index, 1, Indices{});
+                throw;
+            }
+        } else if (index == size_) {
+            EmplaceColumns(data_, index, std::forward_as_tuple(std::forward<Args>(args)...));
+        } else {
+            // args могут ссылаться на сдвигаемые элементы: сначала создаём временную строку
+            std::tuple<Ts...> values(std::forward<Args>(args)...);
+            ShiftAndAssign(index, values, Indices{});
+        }
+        ++size_;
+        return Row(this, index);
+    }
+
+    Row Insert(size_t index, const Ts&... values) {
+        return Emplace(index, values...);
+    }
+
+    Row Insert(size_t index, Ts&&... values) {
+        return Emplace(index, std::move(values)...);
+    }
+
+    // Удаляет строку index, сдвигая хвост каждого столбца
+    void Erase(size_t index) {
+        assert(index < size_);
+        EraseImpl(index, Indices{});
+        DestroyRows(data_, size_ - 1, 1, Indices{});
+        --size_;
+    }
+
+private:
+    // Перенос столбца в новый буфер может бросить исключение: элементы в нём копируются
+    template <typename T>
+    static constexpr bool kTransferMayThrow = !IsTriviallyRelocatableV<T> && !std::is_nothrow_move_constructible_v<T>;
+
+    static Storage MakeStorage(size_t capacity, const Allocator& alloc) {
+        return Storage(RawMemory<Ts, ColumnAllocator<Ts>>(capacity, ColumnAllocator<Ts>(alloc))...);
+    }
+
+    // Освобождает буферы и переключает столбцы на alloc. Элементы должны быть разрушены
+    template <size_t... Is>
+    void ResetStorage(const Allocator& alloc, std::index_sequence<Is...>) noexcept {
+        (std::get<Is>(data_).Reset(ColumnAllocator<Ts>(alloc)), ...);
+    }
+
+    template <size_t... Is>
+    void SetStorageAllocator(const Allocator& alloc, std::index_sequence<Is...>) noexcept {
+        (std::get<Is>(data_).SetAllocator(ColumnAllocator<Ts>(alloc)), ...);
+    }
+
+    // Для каждого столбца I вызывает construct(integral_constant<I>, dst, n), где dst — ячейка
+    // offset буфера столбца в storage. Если столбец бросает исключение, созданные в предыдущих
+    // столбцах элементы разрушаются
+    template <size_t I = 0, typename Construct>
+    static void ConstructColumns(Storage& storage, size_t offset, size_t n, const Construct& construct) {
+        if constexpr (I < kColumnCount) {
+            ColumnType<I>* dst = std::get<I>(storage).GetAddress() + offset;
+            construct(std::integral_constant<size_t, I>{}, dst, n);
+            try {
+                ConstructColumns<I + 1>(storage, offset, n, construct);
+            } catch (...) {
+                std::destroy_n(dst, n);
+                throw;
+            }
+        }
+    }
+
+    // Конструирует поле I строки offset из args[I]
+    template <typename ArgsTuple>
+    static void EmplaceColumns(Storage& storage, size_t offset, ArgsTuple&& args) {
+        ConstructColumns(storage, offset, 1, [&args](auto column, auto* dst, size_t) {
+            using T = std::remove_pointer_t<decltype(dst)>;
+            new (dst) T(std::get<decltype(column)::value>(std::move(args)));
+        });
+    }
+
+    template <size_t... Is>
+    static void DestroyRows(Storage& storage, size_t offset, size_t n, std::index_sequence<Is...>) noexcept {
+        (std::destroy_n(std::get<Is>(storage).GetAddress() + offset, n), ...);
+    }
+
+    template <size_t... Is>
+    static void SwapStorage(Storage& lhs, Storage& rhs, std::index_sequence<Is...>) noexcept {
+        (std::get<Is>(lhs).Swap(std::get<Is>(rhs)), ...);
+    }
+
+    // Переносит строки в new_data, оставляя между [0, gap) и [gap, size_) gap_size
+    // неинициализированных ячеек, и забирает new_data себе. Сначала копируются столбцы,
+    // перенос которых может бросить исключение: до конца копирования исходные элементы целы,
+    // и при ошибке data_ не меняется. Остальные столбцы затем переносятся без исключений
+    void RelocateTo(Storage& new_data, size_t gap = 0, size_t gap_size = 0) {
+        assert(gap <= size_ && size_ + gap_size <= std::get<0>(new_data).Capacity());
+        CopyThrowingColumns(new_data, gap, gap_size);
+        RelocateColumns(new_data, gap, gap_size, Indices{});
+        SwapStorage(data_, new_data, Indices{});
+    }
+
+    template <size_t I = 0>
+    void CopyThrowingColumns(Storage& new_data, size_t gap, size_t gap_size) {
+        if constexpr (I < kColumnCount) {
+            if constexpr (kTransferMayThrow<ColumnType<I>>) {
+                ColumnType<I>* src = Data<I>();
+                ColumnType<I>* dst = std::get<I>(new_data).GetAddress();
+                UninitializedTransferN(src, gap, dst);
+                try {
+                    UninitializedTransferN(src + gap, size_ - gap, dst + gap + gap_size);
+                } catch (...) {
+                    std::destroy_n(dst, gap);
+                    throw;
+                }
+                try {
+                    CopyThrowingColumns<I + 1>(new_data, gap, gap_size);
+                } catch (...) {
+                    std::destroy_n(dst, gap);
+                    std::destroy_n(dst + gap + gap_size, size_ - gap);
+                    throw;
+                }
+            } else {
+                CopyThrowingColumns<I + 1>(new_data, gap, gap_size);
+            }
+        }
+    }
+
+    template <size_t... Is>
+    void RelocateColumns(Storage& new_data, size_t gap, size_t gap_size, std::index_sequence<Is...>) noexcept {
+        (RelocateColumn<Is>(new_data, gap, gap_size), ...);
+    }
+
+    template <size_t I>
+    void RelocateColumn(Storage& new_data, size_t gap, size_t gap_size) noexcept {
+        if constexpr (kTransferMayThrow<ColumnType<I>>) {
+            // Элементы уже скопированы в CopyThrowingColumns
+            std::destroy_n(Data<I>(), size_);
+        } else {
+            UninitializedRelocateN(Data<I>(), size_, std::get<I>(new_data).GetAddress(), gap, gap_size);
+        }
+    }
+
+    // Сдвигает хвост каждого столбца на одну ячейку в пределах ёмкости и записывает values в строку index
+    template <size_t... Is>
+    void ShiftAndAssign(size_t index, std::tuple<Ts...>& values, std::index_sequence<Is...>) noexcept {
+        (ShiftColumn<Is>(index, std::get<Is>(values)), ...);
+    }
+
+    template <size_t I>
+    void ShiftColumn(size_t index, ColumnType<I>& value) noexcept {
+        ColumnType<I>* data = Data<I>();
+        new (data + size_) ColumnType<I>(std::move(data[size_ - 1]));
+        std::move_backward(data + index, data + size_ - 1, data + size_);
+        data[index] = std::move(value);
+    }
+
+    template <size_t... Is>
+    void EraseImpl(size_t index, std::index_sequence<Is...>) {
+        (std::move(Data<Is>() + index + 1, Data<Is>() + size_, Data<Is>() + index), ...);
+    }
+
+    Storage data_;
+    size_t size_ = 0;
+};
+
+template <typename... Ts>
+using SoAVector = BasicSoAVector<std::allocator<std::tuple<Ts...>>, DoublingGrowth, Ts...>;
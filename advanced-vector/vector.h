@@ -5,19 +5,230 @@
 #include <utility>
 #include <memory>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <iterator>
+#include <initializer_list>
+#include <numeric>
 
+#include "growth_policy.h"
+#include "parallel_bulk.h"
+#include "simd_kernels.h"
+#include "vector_stats.h"
+
+// Тип тривиально переносим, если перенос объекта в другую память с последующим
+// забыванием исходного эквивалентен побайтовому копированию.
+// Пользователь может специализировать шаблон для своих типов
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Аллокатор умеет расширять блок на месте: bool TryExpand(T* p, size_t old_n, size_t new_n)
+template <typename Allocator, typename = void>
+struct HasTryExpand : std::false_type {};
+
+template <typename Allocator>
+struct HasTryExpand<Allocator, std::void_t<decltype(std::declval<Allocator&>().TryExpand(
+    std::declval<typename std::allocator_traits<Allocator>::pointer>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Аллокатор умеет переносить блок побайтово, как realloc: T* Reallocate(T* p, size_t old_n, size_t new_n)
+template <typename Allocator, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().Reallocate(
+    std::declval<typename std::allocator_traits<Allocator>::pointer>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Конструирует n элементов в dst из src: перемещением, если оно не бросает исключений
+// (или копирование недоступно), иначе копированием
+template <typename T>
+void UninitializedTransferN(T* src, size_t n, T* dst) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        std::uninitialized_move_n(src, n, dst);
+    } else {
+        std::uninitialized_copy_n(src, n, dst);
+    }
+}
+
+// Переносит n элементов из src в неинициализированную память dst, оставляя после
+// первых gap элементов gap_size свободных ячеек. Исходные элементы разрушаются
+// только при успехе, при исключении src остаётся нетронутым
+template <typename T>
+void UninitializedRelocateN(T* src, size_t n, T* dst, size_t gap = 0, size_t gap_size = 0) {
+    assert(gap <= n);
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        // Побайтовый перенос: деструкторы исходных объектов не вызываются
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(dst), src, gap * sizeof(T));
+            std::memcpy(static_cast<void*>(dst + gap + gap_size), src + gap, (n - gap) * sizeof(T));
+        }
+    } else {
+        UninitializedTransferN(src, gap, dst);
+        try{
+            UninitializedTransferN(src + gap, n - gap, dst + gap + gap_size);
+        }
+        catch(...){
+            std::destroy_n(dst, gap);
+            throw;
+        }
+        std::destroy_n(src, n);
+    }
+}
+
+// Массовые операции над неинициализированной памятью. Если включён BulkParallelism
+// и диапазон не меньше порога, работа делится между потоками пула, иначе выполняется
+// как соответствующий алгоритм std. Гарантии при исключениях те же: созданные
+// элементы разрушаются, и исключение перебрасывается
+
+template <typename T>
+void BulkValueConstructN(T* dst, size_t n) {
+    if (!BulkParallelism::ShouldSplit(n * sizeof(T))) {
+        std::uninitialized_value_construct_n(dst, n);
+        return;
+    }
+    BulkParallelism::ForChunks(n,
+        [dst](size_t begin, size_t end){ std::uninitialized_value_construct_n(dst + begin, end - begin); },
+        [dst](size_t begin, size_t end){ std::destroy_n(dst + begin, end - begin); });
+}
+
+template <typename T>
+void BulkCopyN(const T* src, size_t n, T* dst) {
+    if (!BulkParallelism::ShouldSplit(n * sizeof(T))) {
+        std::uninitialized_copy_n(src, n, dst);
+        return;
+    }
+    BulkParallelism::ForChunks(n,
+        [src, dst](size_t begin, size_t end){ std::uninitialized_copy_n(src + begin, end - begin, dst + begin); },
+        [dst](size_t begin, size_t end){ std::destroy_n(dst + begin, end - begin); });
+}
+
+template <typename T>
+void BulkDestroyN(T* p, size_t n) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        if (!BulkParallelism::ShouldSplit(n * sizeof(T))) {
+            std::destroy_n(p, n);
+            return;
+        }
+        BulkParallelism::ForChunks(n, [p](size_t begin, size_t end){ std::destroy_n(p + begin, end - begin); });
+    }
+}
+
+// Параллельный вариант UninitializedRelocateN с теми же гарантиями
 template <typename T>
+void BulkRelocateN(T* src, size_t n, T* dst, size_t gap = 0, size_t gap_size = 0) {
+    if (!BulkParallelism::ShouldSplit(n * sizeof(T))) {
+        UninitializedRelocateN(src, n, dst, gap, gap_size);
+        return;
+    }
+    assert(gap <= n);
+    // Часть [begin, end) исходных элементов разбивается границей gap на два куска
+    const auto for_pieces = [src, dst, gap, gap_size](size_t begin, size_t end, auto func) {
+        if (begin < gap) {
+            func(src + begin, std::min(end, gap) - begin, dst + begin);
+        }
+        if (end > gap) {
+            const size_t from = std::max(begin, gap);
+            func(src + from, end - from, dst + from + gap_size);
+        }
+    };
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        BulkParallelism::ForChunks(n, [&for_pieces](size_t begin, size_t end){
+            for_pieces(begin, end, [](T* from, size_t count, T* to){
+                std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+            });
+        });
+    } else {
+        BulkParallelism::ForChunks(n,
+            [&for_pieces](size_t begin, size_t end){
+                // Если бросит второй кусок части, созданный первый кусок разрушается
+                T* first_dst = nullptr;
+                size_t first_count = 0;
+                try{
+                    for_pieces(begin, end, [&first_dst, &first_count](T* from, size_t count, T* to){
+                        UninitializedTransferN(from, count, to);
+                        if (first_dst == nullptr) {
+                            first_dst = to;
+                            first_count = count;
+                        }
+                    });
+                }
+                catch(...){
+                    std::destroy_n(first_dst, first_count);
+                    throw;
+                }
+            },
+            [&for_pieces](size_t begin, size_t end){
+                for_pieces(begin, end, [](T*, size_t count, T* to){ std::destroy_n(to, count); });
+            });
+        BulkDestroyN(src, n);
+    }
+}
+
+// Тег, выбирающий инициализацию по умолчанию вместо инициализации значением
+struct DefaultInit {
+    explicit DefaultInit() = default;
+};
+
+inline constexpr DefaultInit kDefaultInit{};
+
+// Тег, с которым Clear возвращает память аллокатору
+struct ReleaseStorage {
+    explicit ReleaseStorage() = default;
+};
+
+inline constexpr ReleaseStorage kReleaseStorage{};
+
+template <typename T, typename Allocator = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Allocator::value_type must match T");
+
 public:
+    using allocator_type = Allocator;
+
+    // Буфер может вырасти без выделения нового блока и поэлементного переноса
+    static constexpr bool kCanTryExpand = HasTryExpand<Allocator>::value;
+    static constexpr bool kCanReallocate = HasReallocate<Allocator>::value && IsTriviallyRelocatableV<T>;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    explicit RawMemory(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity) {
     }
 
+    // Выделения и освобождения памяти учитываются в статистике владельца stats
+    RawMemory(const Allocator& alloc, VectorStatsRecorder<T>* stats) noexcept
+        : alloc_(alloc) {
+        AttachStats(stats);
+    }
+
+    RawMemory(size_t capacity, const Allocator& alloc, VectorStatsRecorder<T>* stats)
+        : alloc_(alloc) {
+        AttachStats(stats);
+        buffer_ = Allocate(capacity);
+        capacity_ = capacity;
+    }
+
     ~RawMemory() {
-        Deallocate(buffer_);
+        Deallocate(buffer_, capacity_);
     }
 
     T* operator+(size_t offset) noexcept {
@@ -39,7 +250,15 @@ public:
         return buffer_[index];
     }
 
+    // Аллокатор обменивается только при propagate_on_container_swap,
+    // иначе обмен буферами допустим лишь между равными аллокаторами
     void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
@@ -56,50 +275,177 @@ public:
         return capacity_;
     }
 
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Указатель на статистику принадлежит владельцу буфера и не переходит вместе с буфером
+    // при перемещении и обмене
+    void AttachStats([[maybe_unused]] VectorStatsRecorder<T>* stats) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        stats_ = stats;
+#endif
+    }
+
+    // Пытается увеличить буфер до new_capacity, не перемещая его.
+    // При успехе элементы остаются на своих местах
+    bool TryExpand(size_t new_capacity) noexcept {
+        if constexpr (kCanTryExpand) {
+            if (buffer_ != nullptr && alloc_.TryExpand(buffer_, capacity_, new_capacity)) {
+                capacity_ = new_capacity;
+                RecordCapacity(new_capacity);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Меняет размер буфера средствами аллокатора (realloc, mremap), при необходимости
+    // побайтово перенося содержимое. Допустимо только для тривиально переносимых T
+    void Reallocate(size_t new_capacity) {
+        static_assert(kCanReallocate, "Allocator::Reallocate requires trivially relocatable T");
+        const bool had_buffer = buffer_ != nullptr;
+        buffer_ = alloc_.Reallocate(buffer_, capacity_, new_capacity);
+        capacity_ = new_capacity;
+        if (had_buffer) {
+            RecordDeallocate();
+        }
+        RecordAllocate(new_capacity);
+    }
+
+    // Освобождает буфер и переключается на другой аллокатор.
+    // Нужен контейнеру для propagate_on_container_copy_assignment
+    void Reset(const Allocator& alloc) noexcept {
+        Deallocate(buffer_, capacity_);
+        buffer_ = nullptr;
+        capacity_ = 0;
+        alloc_ = alloc;
+    }
+
+    // Заменяет аллокатор равным ему, сохраняя буфер: равный аллокатор может его освободить.
+    // Нужен контейнеру для propagate_on_container_copy_assignment
+    void SetAllocator(const Allocator& alloc) noexcept {
+        assert(alloc_ == alloc);
+        alloc_ = alloc;
+    }
+
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
     RawMemory(RawMemory&& other) noexcept 
-    : buffer_(std::exchange(other.buffer_, nullptr))
+    : alloc_(std::move(other.alloc_))
+    , buffer_(std::exchange(other.buffer_, nullptr))
     , capacity_(std::exchange(other.capacity_, 0)) {}
+
+    // Аллокатор перемещается только при propagate_on_container_move_assignment,
+    // иначе забрать чужой буфер можно лишь у равного аллокатора
     RawMemory& operator=(RawMemory&& rhs) noexcept { 
-        buffer_ = std::exchange(rhs.buffer_, nullptr);
-        capacity_ = std::exchange(rhs.capacity_, 0);
+        if (this != &rhs) {
+            Deallocate(buffer_, capacity_);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(rhs.alloc_);
+            } else {
+                assert(alloc_ == rhs.alloc_);
+            }
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
         return *this;
     }
 
 private:
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buf = AllocTraits::allocate(alloc_, n);
+        RecordAllocate(n);
+        return buf;
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+            RecordDeallocate();
+        }
+    }
+
+    void RecordAllocate([[maybe_unused]] size_t capacity) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        VectorTypeStats<T>::OnAllocate(capacity);
+        if (stats_ != nullptr) {
+            stats_->OnAllocate(capacity);
+        }
+#endif
     }
 
+    void RecordDeallocate() noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        VectorTypeStats<T>::OnDeallocate();
+        if (stats_ != nullptr) {
+            stats_->OnDeallocate();
+        }
+#endif
+    }
+
+    void RecordCapacity([[maybe_unused]] size_t capacity) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        VectorTypeStats<T>::OnCapacity(capacity);
+        if (stats_ != nullptr) {
+            stats_->OnCapacity(capacity);
+        }
+#endif
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+#ifdef ADVANCED_VECTOR_STATS
+    VectorStatsRecorder<T>* stats_ = nullptr;
+#endif
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 }; 
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
-    Vector() = default;
+    using allocator_type = Allocator;
+
+    Vector()
+        : data_(Allocator(), &stats_) {
+    }
+
+    explicit Vector(const Allocator& alloc) noexcept
+        : data_(alloc, &stats_) {
+    }
+
+    explicit Vector(size_t size, const Allocator& alloc = Allocator())
+        : data_(size, alloc, &stats_)
+        , size_(size)  
+    {
+        BulkValueConstructN(data_.GetAddress(), size);
+    }
 
-    explicit Vector(size_t size)
-        : data_(size)
+    // Элементы инициализируются по умолчанию: память под тривиальные типы не заполняется
+    Vector(size_t size, DefaultInit, const Allocator& alloc = Allocator())
+        : data_(size, alloc, &stats_)
         , size_(size)  
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
     }
     
     Vector(const Vector& other)
-        : data_(other.size_)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    Vector(const Vector& other, const Allocator& alloc)
+        : data_(other.size_, alloc, &stats_)
         , size_(other.size_)  
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+        BulkCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());
     }
     
     size_t Size() const noexcept {
@@ -110,6 +456,20 @@ public:
         return data_.Capacity();
     }
 
+    const Allocator& GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    // Статистика этого вектора; без ADVANCED_VECTOR_STATS — нули
+    VectorStats GetStats() const noexcept {
+        return stats_.Get();
+    }
+
+    // Статистика всех векторов с элементами типа T; без ADVANCED_VECTOR_STATS — нули
+    static VectorStats GetTypeStats() noexcept {
+        return VectorTypeStats<T>::Get();
+    }
+
     const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
@@ -120,32 +480,86 @@ public:
     }
     
     ~Vector() {
-        std::destroy_n(data_.GetAddress(), size_);
+        BulkDestroyN(data_.GetAddress(), size_);
     }
     
     void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        // Конструируем элементы в new_data, копируя их из data_
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+        if (data_.TryExpand(new_capacity)) {
+            return;
+        }
+        if constexpr (RawMemory<T, Allocator>::kCanReallocate) {
+            data_.Reallocate(new_capacity);
+            stats_.OnTransfer(0, 0, size_);
         } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator(), &stats_);
+            RelocateTo(new_data);
         }
-        // Разрушаем элементы в data_
+    }
+
+    // Уменьшает ёмкость до размера. Тривиально переносимые элементы переносятся
+    // побайтово, а при поддержке аллокатором — через Reallocate
+    void ShrinkToFit() {
+        if (size_ == data_.Capacity()) {
+            return;
+        }
+        if (size_ == 0) {
+            data_ = RawMemory<T, Allocator>(data_.GetAllocator());
+            return;
+        }
+        if constexpr (RawMemory<T, Allocator>::kCanReallocate) {
+            data_.Reallocate(size_);
+            stats_.OnTransfer(0, 0, size_);
+        } else {
+            RawMemory<T, Allocator> new_data(size_, data_.GetAllocator(), &stats_);
+            RelocateTo(new_data);
+        }
+    }
+
+    // Вызывает ShrinkToFit, если ёмкость превышает размер более чем в max_ratio раз.
+    // Возвращает true, если память была перераспределена
+    bool ShrinkIfWasteful(double max_ratio) {
+        assert(max_ratio >= 1.0);
+        if (static_cast<double>(data_.Capacity()) <= static_cast<double>(size_) * max_ratio) {
+            return false;
+        }
+        ShrinkToFit();
+        return true;
+    }
+
+    // Разрушает элементы, сохраняя ёмкость
+    void Clear() noexcept {
         std::destroy_n(data_.GetAddress(), size_);
-        // Избавляемся от старой сырой памяти, обменивая её на новую
-        data_.Swap(new_data);
-        // При выходе из метода старая память будет возвращена в кучу
+        size_ = 0;
+    }
+
+    // Разрушает элементы и освобождает память
+    void Clear(ReleaseStorage) noexcept {
+        Clear();
+        data_ = RawMemory<T, Allocator>(data_.GetAllocator());
     }
 
     Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Текущие элементы и буфер принадлежат старому аллокатору
+                    std::destroy_n(data_.GetAddress(), size_);
+                    size_ = 0;
+                    data_.Reset(rhs.GetAllocator());
+                } else {
+                    // Равный аллокатор всё равно копируется: его состояние может не влиять на равенство
+                    data_.SetAllocator(rhs.GetAllocator());
+                }
+            }
             if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+                RawMemory<T, Allocator> new_data(rhs.size_, data_.GetAllocator(), &stats_);
+                std::uninitialized_copy_n(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.Swap(new_data);
+                size_ = rhs.size_;
             } else {
                 const size_t min_size = std::min(rhs.size_, size_);
                 for(size_t i = 0; i < min_size; ++i){
@@ -165,11 +579,27 @@ public:
 
     Vector(Vector&& other) noexcept
     : data_(std::move(other.data_))
-    , size_(std::exchange(other.size_, 0)){}
+    , size_(std::exchange(other.size_, 0)){
+        data_.AttachStats(&stats_);
+    }
 
-    Vector& operator=(Vector&& rhs) noexcept{
-        data_ = std::move(rhs.data_);
-        size_ = std::exchange(rhs.size_, 0);
+    Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (AllocTraits::propagate_on_container_move_assignment::value
+                || GetAllocator() == rhs.GetAllocator()) {
+                std::destroy_n(data_.GetAddress(), size_);
+                data_ = std::move(rhs.data_);
+                size_ = std::exchange(rhs.size_, 0);
+            } else {
+                // Чужой буфер забрать нельзя: перемещаем элементы поштучно в память своего аллокатора
+                RawMemory<T, Allocator> new_data(rhs.size_, data_.GetAllocator(), &stats_);
+                std::uninitialized_move_n(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.Swap(new_data);
+                size_ = rhs.size_;
+            }
+        }
         return *this;
     }
 
@@ -190,47 +620,26 @@ public:
         }
         size_ = new_size;
     }
-    void PushBack(const T& value){
-        if (size_ < data_.Capacity()) {
-            new (data_ + size_) T(value);
+    // Новые элементы инициализируются по умолчанию, а не значением: для тривиальных
+    // типов их память остаётся неинициализированной и должна быть перезаписана
+    void Resize(size_t new_size, DefaultInit){
+        if(new_size < size_){
+            std::destroy_n(data_ + new_size, size_ - new_size);
         }
         else{
-            RawMemory<T> new_data((size_ == 0) ? 1 : (2 * size_));
-            new (new_data + size_) T(value);
-            // Конструируем элементы в new_data, копируя их из data_
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            } else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            // Разрушаем элементы в data_
-            std::destroy_n(data_.GetAddress(), size_);
-            // Избавляемся от старой сырой памяти, обменивая её на новую
-            data_.Swap(new_data);
-            // При выходе из метода старая память будет возвращена в кучу
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_ + size_, new_size - size_);
         }
-        ++size_;
+        size_ = new_size;
+    }
+    void ResizeForOverwrite(size_t new_size){
+        Resize(new_size, kDefaultInit);
+    }
+    void PushBack(const T& value){
+        EmplaceBack(value);
     }
     void PushBack(T&& value){
-        if (size_ < data_.Capacity()) {
-            new (data_ + size_) T(std::move(value));
-        }
-        else{
-            RawMemory<T> new_data((size_ == 0) ? 1 : (2 * size_));
-            new (new_data + size_) T(std::move(value));
-            // Конструируем элементы в new_data, копируя их из data_
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            } else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            // Разрушаем элементы в data_
-            std::destroy_n(data_.GetAddress(), size_);
-            // Избавляемся от старой сырой памяти, обменивая её на новую
-            data_.Swap(new_data);
-            // При выходе из метода старая память будет возвращена в кучу
-        }
-        ++size_;
+        EmplaceBack(std::move(value));
     }
     void PopBack()  noexcept {
         --size_;
@@ -243,19 +652,7 @@ public:
             new (data_ + size_) T(std::forward<Args>(args)...);
         }
         else{
-            RawMemory<T> new_data((size_ == 0) ? 1 : (2 * size_));
-            new (new_data + size_) T(std::forward<Args>(args)...);
-            // Конструируем элементы в new_data, копируя их из data_
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            } else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            // Разрушаем элементы в data_
-            std::destroy_n(data_.GetAddress(), size_);
-            // Избавляемся от старой сырой памяти, обменивая её на новую
-            data_.Swap(new_data);
-            // При выходе из метода старая память будет возвращена в кучу
+            EmplaceWithReallocation(size_, std::forward<Args>(args)...);
         }
         ++size_;
         return *(data_ + size_ - 1);
@@ -292,38 +689,10 @@ public:
         }
         if (size_ < data_.Capacity()) {
             T value(std::forward<Args>(args)...);
-            std::uninitialized_move(data_ + size_ - 1, data_ + size_, data_ + size_);
-            std::move_backward(data_ + pos_, data_ + size_ - 1, data_ + size_);
-            *(data_ + pos_) =  std::move(value);
+            MoveIntoSpareCapacity(pos_, std::move(value));
         }
         else{
-            RawMemory<T> new_data((size_ == 0) ? 1 : (2 * size_));
-            new (new_data + pos_) T(std::forward<Args>(args)...);
-            // Конструируем элементы в new_data, копируя их из data_
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), pos_, new_data.GetAddress());
-                try{
-                    std::uninitialized_move_n(data_.GetAddress() + pos_, size_ - pos_, new_data.GetAddress() + pos_ + 1);
-                }
-                catch(...){
-                    std::destroy_n(new_data.GetAddress(), pos_);
-                    throw;
-                }
-            } else {
-                std::uninitialized_copy_n(data_.GetAddress(), pos_, new_data.GetAddress());
-                try{
-                    std::uninitialized_copy_n(data_.GetAddress() + pos_, size_ - pos_, new_data.GetAddress() + pos_ + 1);
-                }
-                catch(...){
-                    std::destroy_n(new_data.GetAddress(), pos_);
-                    throw;
-                }
-            }
-            // Разрушаем элементы в data_
-            std::destroy_n(data_.GetAddress(), size_);
-            // Избавляемся от старой сырой памяти, обменивая её на новую
-            data_.Swap(new_data);
-            // При выходе из метода старая память будет возвращена в кучу
+            EmplaceWithReallocation(pos_, std::forward<Args>(args)...);
         }
         ++size_;
         return data_ + pos_;
@@ -335,13 +704,300 @@ public:
         --size_;
         return data_ + pos_;
     }
+    // Удаляет [first, last) одним сдвигом хвоста и разрушает освободившиеся элементы разом
+    iterator Erase(const_iterator first, const_iterator last){
+        const size_t index = std::distance(cbegin(), first);
+        const size_t count = std::distance(first, last);
+        if (count != 0) {
+            std::move(data_ + index + count, data_ + size_, data_ + index);
+            std::destroy_n(data_ + size_ - count, count);
+            size_ -= count;
+        }
+        return data_ + index;
+    }
     iterator Insert(const_iterator pos, const T& value){
         return Emplace(pos, value);
     }
     iterator Insert(const_iterator pos, T&& value){
         return Emplace(pos, std::move(value));
     }
+
+    // Вставляет count копий value за одно перераспределение памяти и один сдвиг хвоста
+    iterator Insert(const_iterator pos, size_t count, const T& value){
+        // value может ссылаться на элемент, который сдвинется
+        const T value_copy(value);
+        return InsertN(std::distance(cbegin(), pos), count,
+            [&value_copy](T* dst, size_t, size_t n){ std::uninitialized_fill_n(dst, n, value_copy); },
+            [&value_copy](T* dst, size_t, size_t n){ std::fill_n(dst, n, value_copy); });
+    }
+
+    // Вставляет элементы [first, last), которые не должны принадлежать этому вектору.
+    // Для однонаправленных итераторов итоговый размер известен заранее: память
+    // перераспределяется не более одного раза, а хвост сдвигается ровно один раз
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last){
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        const size_t index = std::distance(cbegin(), pos);
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            return InsertN(index, std::distance(first, last),
+                [first](T* dst, size_t offset, size_t n){ std::uninitialized_copy_n(std::next(first, offset), n, dst); },
+                [first](T* dst, size_t offset, size_t n){ std::copy_n(std::next(first, offset), n, dst); });
+        } else {
+            // Длина однопроходного диапазона неизвестна: дописываем в конец и переставляем
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(data_ + index, data_ + old_size, data_ + size_);
+            return data_ + index;
+        }
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> values){
+        return Insert(pos, values.begin(), values.end());
+    }
+
+    // Дописывает в конец все элементы диапазона range, который не должен принадлежать этому
+    // вектору. Хвоста нет, поэтому элементы создаются сразу за концом без сдвига. Для
+    // однонаправленных итераторов память выделяется одним Reserve, который сначала пробует
+    // расширить буфер на месте, а при исключении элементы вектора не меняются
+    template <typename Range>
+    void AppendRange(Range&& range){
+        auto first = std::begin(range);
+        auto last = std::end(range);
+        using Category = typename std::iterator_traits<decltype(first)>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            const size_t count = std::distance(first, last);
+            if (size_ + count > data_.Capacity()) {
+                Reserve(std::max(size_ + count, GrowthPolicy::template NextCapacity<T>(size_)));
+            }
+            std::uninitialized_copy(first, last, data_ + size_);
+            size_ += count;
+        } else {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+    // Поиск и агрегаты. Для 32- и 64-битных целых, float и double работают SIMD-ядра,
+    // выбранные по cpuid, для остальных типов — алгоритмы std
+    iterator Find(const T& value){
+        return data_ + SimdFind(data_.GetAddress(), size_, value);
+    }
+
+    const_iterator Find(const T& value) const{
+        return data_ + SimdFind(data_.GetAddress(), size_, value);
+    }
+
+    size_t Count(const T& value) const{
+        return SimdCount(data_.GetAddress(), size_, value);
+    }
+
+    bool Contains(const T& value) const{
+        return SimdFind(data_.GetAddress(), size_, value) != size_;
+    }
+
+    // Наименьший элемент непустого вектора. Для чисел с плавающей точкой NaN пропускаются
+    decltype(auto) Min() const{
+        assert(size_ > 0);
+        if constexpr (std::is_arithmetic_v<T>) {
+            return SimdMin(data_.GetAddress(), size_);
+        } else {
+            return *std::min_element(begin(), end());
+        }
+    }
+
+    // Наибольший элемент непустого вектора. Для чисел с плавающей точкой NaN пропускаются
+    decltype(auto) Max() const{
+        assert(size_ > 0);
+        if constexpr (std::is_arithmetic_v<T>) {
+            return SimdMax(data_.GetAddress(), size_);
+        } else {
+            return *std::max_element(begin(), end());
+        }
+    }
+
+    // Сумма элементов: целые складываются в 64 битах, прочие типы — начиная с T{}
+    auto Sum() const{
+        if constexpr (std::is_arithmetic_v<T>) {
+            return SimdSum(data_.GetAddress(), size_);
+        } else {
+            return std::accumulate(begin(), end(), T{});
+        }
+    }
+
 private:
-    RawMemory<T> data_;
+    // Вставляет count элементов в позицию index. construct(dst, offset, n) создаёт в сырой
+    // памяти dst элементы источника [offset, offset + n), assign(dst, offset, n) присваивает их
+    // существующим элементам. Источник не должен ссылаться на элементы вектора
+    template <typename Construct, typename Assign>
+    iterator InsertN(size_t index, size_t count, Construct construct, Assign assign){
+        assert(index <= size_);
+        if (count == 0) {
+            return data_ + index;
+        }
+        if (size_ + count > data_.Capacity()) {
+            const size_t new_capacity = std::max(size_ + count, GrowthPolicy::template NextCapacity<T>(size_));
+            RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator(), &stats_);
+            construct(new_data + index, 0, count);
+            try{
+                RelocateTo(new_data, index, count);
+            }
+            catch(...){
+                std::destroy_n(new_data + index, count);
+                throw;
+            }
+            size_ += count;
+            return data_ + index;
+        }
+        T* pos = data_ + index;
+        T* end = data_ + size_;
+        const size_t tail = size_ - index;
+        if (count <= tail) {
+            // Последние count элементов переезжают в сырую память, остальные сдвигаются присваиванием
+            std::uninitialized_move(end - count, end, end);
+            size_ += count;
+            std::move_backward(pos, end - count, end);
+            assign(pos, 0, count);
+        } else {
+            // Часть новых элементов сразу попадает в сырую память за концом
+            construct(end, tail, count - tail);
+            try{
+                std::uninitialized_move(pos, end, end + count - tail);
+            }
+            catch(...){
+                std::destroy_n(end, count - tail);
+                throw;
+            }
+            size_ += count;
+            assign(pos, 0, tail);
+        }
+        return pos;
+    }
+
+    // Переносит элементы в new_data, оставляя между [0, gap) и [gap, size_) gap_size
+    // неинициализированных ячеек, и забирает new_data себе.
+    // При исключении data_ остаётся нетронутым
+    void RelocateTo(RawMemory<T, Allocator>& new_data, size_t gap = 0, size_t gap_size = 0) {
+        assert(gap <= size_ && size_ + gap_size <= new_data.Capacity());
+        BulkRelocateN(data_.GetAddress(), size_, new_data.GetAddress(), gap, gap_size);
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            stats_.OnTransfer(0, 0, size_);
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            stats_.OnTransfer(size_, 0, 0);
+        } else {
+            stats_.OnTransfer(0, size_, 0);
+        }
+        // Избавляемся от старой сырой памяти, обменивая её на новую
+        data_.Swap(new_data);
+        // При выходе из вызывающего метода старая память будет возвращена в кучу
+    }
+
+    // Вставляет value в позицию pos, сдвигая хвост в пределах текущей ёмкости
+    void MoveIntoSpareCapacity(size_t pos, T&& value) {
+        assert(pos <= size_ && size_ < data_.Capacity());
+        if (pos == size_) {
+            new (data_ + size_) T(std::move(value));
+            return;
+        }
+        std::uninitialized_move(data_ + size_ - 1, data_ + size_, data_ + size_);
+        std::move_backward(data_ + pos, data_ + size_ - 1, data_ + size_);
+        *(data_ + pos) = std::move(value);
+    }
+
+    // Конструирует новый элемент в позиции pos свежего буфера и переносит туда остальные.
+    // Элемент создаётся до переноса, так как args могут ссылаться на элементы вектора
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t pos, Args&&... args) {
+        const size_t new_capacity = GrowthPolicy::template NextCapacity<T>(size_);
+        assert(new_capacity > size_);
+        if constexpr (RawMemory<T, Allocator>::kCanTryExpand || RawMemory<T, Allocator>::kCanReallocate) {
+            // Буфер может вырасти на месте, поэтому элемент сначала создаётся во временном объекте
+            T value(std::forward<Args>(args)...);
+            Reserve(new_capacity);
+            MoveIntoSpareCapacity(pos, std::move(value));
+        } else {
+            RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator(), &stats_);
+            new (new_data + pos) T(std::forward<Args>(args)...);
+            try{
+                RelocateTo(new_data, pos, 1);
+            }
+            catch(...){
+                std::destroy_at(new_data + pos);
+                throw;
+            }
+        }
+    }
+
+    // Объявлен раньше data_, чтобы быть готовым к учёту первого выделения памяти
+    [[no_unique_address]] VectorStatsRecorder<T> stats_;
+    RawMemory<T, Allocator> data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+};
+
+// Удаляет элементы, удовлетворяющие pred, за один проход уплотнения.
+// Возвращает количество удалённых элементов
+template <typename T, typename Allocator, typename GrowthPolicy, typename Predicate>
+size_t EraseIf(Vector<T, Allocator, GrowthPolicy>& vector, Predicate pred) {
+    const auto new_end = std::remove_if(vector.begin(), vector.end(), pred);
+    const size_t removed = std::distance(new_end, vector.end());
+    vector.Erase(new_end, vector.end());
+    return removed;
+}
+
+// Удаляет элементы, равные value, за один проход уплотнения.
+// Возвращает количество удалённых элементов
+template <typename T, typename Allocator, typename GrowthPolicy, typename U>
+size_t Erase(Vector<T, Allocator, GrowthPolicy>& vector, const U& value) {
+    const auto new_end = std::remove(vector.begin(), vector.end(), value);
+    const size_t removed = std::distance(new_end, vector.end());
+    vector.Erase(new_end, vector.end());
+    return removed;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator==(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) {
+    return lhs.Size() == rhs.Size() && SimdMismatch(lhs.begin(), rhs.begin(), lhs.Size()) == lhs.Size();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator!=(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+// Лексикографическое сравнение. Для арифметических типов первое расхождение ищется
+// SIMD-ядром; неупорядоченные пары (NaN) пропускаются, как в std::lexicographical_compare
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator<(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        const size_t n = std::min(lhs.Size(), rhs.Size());
+        for (size_t i = SimdMismatch(lhs.begin(), rhs.begin(), n); i != n;
+             i += 1 + SimdMismatch(lhs.begin() + i + 1, rhs.begin() + i + 1, n - i - 1)) {
+            if (lhs[i] < rhs[i]) {
+                return true;
+            }
+            if (rhs[i] < lhs[i]) {
+                return false;
+            }
+        }
+        return lhs.Size() < rhs.Size();
+    } else {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator>(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator<=(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+bool operator>=(const Vector<T, Allocator, GrowthPolicy>& lhs, const Vector<T, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,191 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "growth_policy.h"
+#include "vector.h"
+
+// Монотонная арена для пачек короткоживущих векторов. Память выделяется сдвигом указателя
+// внутри блоков, блоки связаны в список и растут вдвое. Освобождение отдельных буферов
+// ничего не делает: вся память возвращается сразу вызовом Reset или деструктором арены.
+// Последний выделенный буфер может расти на месте, пока в текущем блоке есть место.
+// Арена не потокобезопасна и не перемещается: аллокаторы хранят указатель на неё
+class VectorArena {
+public:
+    static constexpr size_t kDefaultChunkBytes = size_t{64} << 10;
+
+    explicit VectorArena(size_t first_chunk_bytes = kDefaultChunkBytes) noexcept
+        : next_chunk_bytes_(std::max(first_chunk_bytes, sizeof(Chunk))) {
+    }
+
+    VectorArena(const VectorArena&) = delete;
+    VectorArena& operator=(const VectorArena&) = delete;
+
+    ~VectorArena() {
+        FreeChunks(chunks_);
+    }
+
+    void* Allocate(size_t bytes, size_t align) {
+        assert(align != 0 && (align & (align - 1)) == 0);
+        // Отступ выравнивания проверяется до сдвига указателя: конец блока бывает
+        // невыровненным, и выровненный указатель может оказаться за ним
+        if (!Fits(Padding(current_, align), bytes)) {
+            AddChunk(bytes, align);
+        }
+        char* p = current_ + Padding(current_, align);
+        current_ = p + bytes;
+        return p;
+    }
+
+    // Расширяет блок p до new_bytes, если он выделен последним и в текущем блоке хватает места
+    bool TryExpand(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+        char* begin = static_cast<char*>(p);
+        if (begin + old_bytes != current_ || static_cast<size_t>(end_ - begin) < new_bytes) {
+            return false;
+        }
+        current_ = begin + new_bytes;
+        return true;
+    }
+
+    // Возвращает всю выделенную память. Самый большой блок остаётся для следующих выделений,
+    // остальные освобождаются. Буферы, выделенные до Reset, использовать больше нельзя
+    void Reset() noexcept {
+        if (chunks_ == nullptr) {
+            return;
+        }
+        FreeChunks(chunks_->next);
+        chunks_->next = nullptr;
+        reserved_bytes_ = chunks_->bytes;
+        current_ = reinterpret_cast<char*>(chunks_ + 1);
+        end_ = reinterpret_cast<char*>(chunks_) + chunks_->bytes;
+    }
+
+    // Освобождает все блоки
+    void Release() noexcept {
+        FreeChunks(chunks_);
+        chunks_ = nullptr;
+        reserved_bytes_ = 0;
+        current_ = nullptr;
+        end_ = nullptr;
+    }
+
+    // Байты, занятые выделенными буферами и выравниванием в текущем блоке, плюс все прежние блоки
+    size_t UsedBytes() const noexcept {
+        return chunks_ == nullptr ? 0 : reserved_bytes_ - static_cast<size_t>(end_ - current_);
+    }
+
+    // Суммарный размер блоков, взятых у системы
+    size_t ReservedBytes() const noexcept {
+        return reserved_bytes_;
+    }
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        size_t bytes;
+    };
+
+    static size_t Padding(const char* p, size_t align) noexcept {
+        const auto address = reinterpret_cast<uintptr_t>(p);
+        return (align - address % align) % align;
+    }
+
+    // В текущем блоке помещаются padding байт выравнивания и bytes байт буфера
+    bool Fits(size_t padding, size_t bytes) const noexcept {
+        if (current_ == nullptr) {
+            return false;
+        }
+        const auto available = static_cast<size_t>(end_ - current_);
+        return padding <= available && bytes <= available - padding;
+    }
+
+    static void FreeChunks(Chunk* chunk) noexcept {
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next;
+            ::operator delete(chunk);
+            chunk = next;
+        }
+    }
+
+    // Новый блок вдвое больше предыдущего и вмещает bytes с выравниванием align
+    void AddChunk(size_t bytes, size_t align) {
+        const size_t limit = std::numeric_limits<size_t>::max() - sizeof(Chunk) - align;
+        if (bytes > limit) {
+            throw std::bad_alloc();
+        }
+        const size_t chunk_bytes = std::max(next_chunk_bytes_, sizeof(Chunk) + bytes + align - 1);
+        auto* chunk = static_cast<Chunk*>(::operator new(chunk_bytes));
+        chunk->next = chunks_;
+        chunk->bytes = chunk_bytes;
+        chunks_ = chunk;
+        reserved_bytes_ += chunk_bytes;
+        current_ = reinterpret_cast<char*>(chunk + 1);
+        end_ = reinterpret_cast<char*>(chunk) + chunk_bytes;
+        next_chunk_bytes_ = chunk_bytes <= limit / 2 ? chunk_bytes * 2 : chunk_bytes;
+    }
+
+    // Текущий блок — голова списка
+    Chunk* chunks_ = nullptr;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    size_t next_chunk_bytes_;
+    size_t reserved_bytes_ = 0;
+};
+
+// Аллокатор поверх VectorArena. deallocate ничего не делает, а TryExpand позволяет
+// RawMemory расти на месте, когда буфер выделен в арене последним
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(VectorArena& arena) noexcept
+        : arena_(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(&other.GetArena()) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {
+    }
+
+    bool TryExpand(T* p, size_t old_n, size_t new_n) noexcept {
+        return new_n <= std::numeric_limits<size_t>::max() / sizeof(T)
+            && arena_->TryExpand(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    VectorArena& GetArena() const noexcept {
+        return *arena_;
+    }
+
+private:
+    VectorArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+    return &lhs.GetArena() == &rhs.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+// Вектор, буфер которого выделяется в арене: ArenaVector<int> v(arena)
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+using ArenaVector = Vector<T, ArenaAllocator<T>, GrowthPolicy>;
@@ -0,0 +1,352 @@
+#pragma once
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "vector.h"
+
+// Двоичный формат Vector тривиально копируемых элементов: заголовок из kDataOffset байт
+// и сразу за ним элементы в том виде, в каком они лежат в памяти. Порядок байт —
+// порядок байт машины; файл другого порядка отвергается по magic
+struct SerializedVectorHeader {
+    static constexpr uint64_t kMagic = 0x4C41495245535641ull;  // "AVSERIAL"
+    static constexpr uint32_t kVersion = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint32_t alignment;
+    uint32_t reserved;
+    uint64_t size;
+    // Контрольная сумма байт элементов
+    uint64_t checksum;
+    uint8_t padding[24];
+};
+
+namespace serialization_detail {
+
+// Данные начинаются с этого смещения: в отображённом файле они выровнены на 64 байта
+inline constexpr size_t kDataOffset = 64;
+
+static_assert(sizeof(SerializedVectorHeader) == kDataOffset);
+
+[[noreturn]] inline void ThrowSystemError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), std::string("Serialization: ") + what);
+}
+
+// Закрывает дескриптор при выходе из области видимости
+class FileDescriptor {
+public:
+    FileDescriptor(const std::string& path, int flags) {
+        fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open");
+        }
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    ~FileDescriptor() {
+        ::close(fd_);
+    }
+
+    int Get() const noexcept {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+inline uint64_t RotateLeft(uint64_t value, unsigned shift) noexcept {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+// Четыре независимые полосы по раунду xxHash64: зависимости между словами соседних
+// полос нет, и сумма считается со скоростью, близкой к чтению памяти
+inline uint64_t Checksum(const void* data, size_t bytes) noexcept {
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    const auto round = [](uint64_t acc, uint64_t word) {
+        return RotateLeft(acc + word * kPrime2, 31) * kPrime1;
+    };
+    const auto* bytes_ptr = static_cast<const unsigned char*>(data);
+    uint64_t lanes[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    size_t offset = 0;
+    for (; offset + 32 <= bytes; offset += 32) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, bytes_ptr + offset + lane * 8, sizeof(word));
+            lanes[lane] = round(lanes[lane], word);
+        }
+    }
+    uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12)
+                    + RotateLeft(lanes[3], 18) + bytes;
+    for (; offset < bytes; ++offset) {
+        hash = round(hash, bytes_ptr[offset]);
+    }
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+template <typename T>
+SerializedVectorHeader MakeHeader(const T* data, size_t size) noexcept {
+    SerializedVectorHeader header{};
+    header.magic = SerializedVectorHeader::kMagic;
+    header.version = SerializedVectorHeader::kVersion;
+    header.element_size = sizeof(T);
+    header.alignment = alignof(T);
+    header.size = size;
+    header.checksum = Checksum(data, size * sizeof(T));
+    return header;
+}
+
+// Бросает std::runtime_error, если заголовок описывает вектор другого типа
+// или файл короче заявленных данных
+template <typename T>
+void CheckHeader(const SerializedVectorHeader& header, size_t available_bytes) {
+    if (header.magic != SerializedVectorHeader::kMagic || header.version != SerializedVectorHeader::kVersion) {
+        throw std::runtime_error("Serialization: not a serialized vector");
+    }
+    if (header.element_size != sizeof(T) || header.alignment != alignof(T)) {
+        throw std::runtime_error("Serialization: element type mismatch");
+    }
+    if (header.size > available_bytes / sizeof(T)) {
+        throw std::runtime_error("Serialization: data is truncated");
+    }
+}
+
+// Записывает все iovec, повторяя writev после неполной записи
+inline void WriteAll(int fd, iovec* iov, int count) {
+    while (count > 0) {
+        const ssize_t written = ::writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowSystemError("writev");
+        }
+        size_t rest = static_cast<size_t>(written);
+        while (count > 0 && rest >= iov->iov_len) {
+            rest -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + rest;
+            iov->iov_len -= rest;
+        }
+    }
+}
+
+// Байты от текущей позиции до конца обычного файла. Для каналов и сокетов размер
+// неизвестен, и длина данных ограничивается только заголовком
+inline size_t RemainingBytes(int fd) {
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ThrowSystemError("fstat");
+    }
+    const off_t position = S_ISREG(st.st_mode) ? ::lseek(fd, 0, SEEK_CUR) : -1;
+    if (position < 0 || position > st.st_size) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return static_cast<size_t>(st.st_size - position);
+}
+
+inline void ReadAll(int fd, void* buffer, size_t bytes) {
+    auto* dst = static_cast<char*>(buffer);
+    while (bytes > 0) {
+        const ssize_t got = ::read(fd, dst, bytes);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowSystemError("read");
+        }
+        if (got == 0) {
+            throw std::runtime_error("Serialization: data is truncated");
+        }
+        dst += got;
+        bytes -= static_cast<size_t>(got);
+    }
+}
+
+}  // namespace serialization_detail
+
+// Записывает заголовок и элементы vector в fd одним вызовом writev
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Serialize(int fd, const Vector<T, Allocator, GrowthPolicy>& vector) {
+    static_assert(std::is_trivially_copyable_v<T>, "Serialize requires trivially copyable T");
+    SerializedVectorHeader header = serialization_detail::MakeHeader(vector.begin(), vector.Size());
+    iovec iov[2] = {
+        {&header, sizeof(header)},
+        {const_cast<T*>(vector.begin()), vector.Size() * sizeof(T)},
+    };
+    serialization_detail::WriteAll(fd, iov, 2);
+}
+
+// Создаёт или перезаписывает файл path
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Serialize(const std::string& path, const Vector<T, Allocator, GrowthPolicy>& vector) {
+    const serialization_detail::FileDescriptor file(path, O_WRONLY | O_CREAT | O_TRUNC);
+    Serialize(file.Get(), vector);
+}
+
+// Читает вектор из fd прямо в буфер vector нужного размера. Прежнее содержимое vector
+// заменяется. Бросает std::runtime_error при несовпадении типа, обрезанных данных
+// или неверной контрольной сумме. Если неверен заголовок, vector не меняется,
+// если данные — остаётся пустым
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Deserialize(int fd, Vector<T, Allocator, GrowthPolicy>& vector) {
+    static_assert(std::is_trivially_copyable_v<T>, "Deserialize requires trivially copyable T");
+    SerializedVectorHeader header;
+    serialization_detail::ReadAll(fd, &header, sizeof(header));
+    serialization_detail::CheckHeader<T>(header, serialization_detail::RemainingBytes(fd));
+    vector.Clear();
+    vector.ResizeForOverwrite(static_cast<size_t>(header.size));
+    try {
+        serialization_detail::ReadAll(fd, vector.begin(), vector.Size() * sizeof(T));
+        if (serialization_detail::Checksum(vector.begin(), vector.Size() * sizeof(T)) != header.checksum) {
+            throw std::runtime_error("Serialization: checksum mismatch");
+        }
+    } catch (...) {
+        vector.Clear();
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Deserialize(const std::string& path, Vector<T, Allocator, GrowthPolicy>& vector) {
+    const serialization_detail::FileDescriptor file(path, O_RDONLY);
+    Deserialize(file.Get(), vector);
+}
+
+// Вектор, записанный Serialize, отображённый в память только для чтения. Элементы
+// не копируются: страницы файла подгружаются при обращении. Конструктор проверяет
+// заголовок, контрольную сумму — отдельный вызов VerifyChecksum, которому нужно
+// прочитать весь файл
+template <typename T>
+class MappedVectorView {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVectorView requires trivially copyable T");
+    static_assert(alignof(T) <= serialization_detail::kDataOffset, "T is too strictly aligned for MappedVectorView");
+
+public:
+    using const_iterator = const T*;
+
+    // Бросает std::system_error при ошибке ввода-вывода и std::runtime_error,
+    // если файл содержит вектор другого типа
+    explicit MappedVectorView(const std::string& path) {
+        const serialization_detail::FileDescriptor file(path, O_RDONLY);
+        struct stat st {};
+        if (::fstat(file.Get(), &st) != 0) {
+            serialization_detail::ThrowSystemError("fstat");
+        }
+        const size_t file_bytes = static_cast<size_t>(st.st_size);
+        if (file_bytes < serialization_detail::kDataOffset) {
+            throw std::runtime_error("Serialization: not a serialized vector");
+        }
+        void* map = ::mmap(nullptr, file_bytes, PROT_READ, MAP_SHARED, file.Get(), 0);
+        if (map == MAP_FAILED) {
+            serialization_detail::ThrowSystemError("mmap");
+        }
+        map_ = map;
+        mapped_bytes_ = file_bytes;
+        try {
+            serialization_detail::CheckHeader<T>(GetHeader(), file_bytes - serialization_detail::kDataOffset);
+        } catch (...) {
+            Unmap();
+            throw;
+        }
+    }
+
+    MappedVectorView(const MappedVectorView&) = delete;
+    MappedVectorView& operator=(const MappedVectorView&) = delete;
+
+    MappedVectorView(MappedVectorView&& other) noexcept
+        : map_(std::exchange(other.map_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0)) {
+    }
+
+    MappedVectorView& operator=(MappedVectorView&& rhs) noexcept {
+        if (this != &rhs) {
+            Unmap();
+            map_ = std::exchange(rhs.map_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedVectorView() {
+        Unmap();
+    }
+
+    size_t Size() const noexcept {
+        return map_ != nullptr ? static_cast<size_t>(GetHeader().size) : 0;
+    }
+
+    const T* Data() const noexcept {
+        return map_ != nullptr
+                   ? reinterpret_cast<const T*>(static_cast<const char*>(map_) + serialization_detail::kDataOffset)
+                   : nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+
+    // true, если элементы совпадают с записанной контрольной суммой
+    bool VerifyChecksum() const noexcept {
+        return map_ == nullptr
+               || serialization_detail::Checksum(Data(), Size() * sizeof(T)) == GetHeader().checksum;
+    }
+
+    // Копия элементов в обычном векторе
+    Vector<T> ToVector() const {
+        Vector<T> result(Size(), kDefaultInit);
+        if (Size() != 0) {
+            std::memcpy(static_cast<void*>(result.begin()), Data(), Size() * sizeof(T));
+        }
+        return result;
+    }
+
+private:
+    const SerializedVectorHeader& GetHeader() const noexcept {
+        return *static_cast<const SerializedVectorHeader*>(map_);
+    }
+
+    void Unmap() noexcept {
+        if (map_ != nullptr) {
+            ::munmap(map_, mapped_bytes_);
+            map_ = nullptr;
+            mapped_bytes_ = 0;
+        }
+    }
+
+    void* map_ = nullptr;
+    size_t mapped_bytes_ = 0;
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Статистика выделений памяти и переноса элементов при росте. Собирается, только
+// если ADVANCED_VECTOR_STATS определён до включения vector.h (или флагом компилятора).
+// Иначе счётчики не хранятся и не обновляются, а запросы возвращают нули
+#ifdef ADVANCED_VECTOR_STATS
+inline constexpr bool kVectorStatsEnabled = true;
+#else
+inline constexpr bool kVectorStatsEnabled = false;
+#endif
+
+struct VectorStats {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytes_allocated = 0;
+    // Элементы, перенесённые при росте: перемещением; копированием, когда перемещение
+    // может бросить исключение; побайтово, если тип тривиально переносим
+    size_t elements_moved = 0;
+    size_t elements_copied = 0;
+    size_t elements_relocated = 0;
+    size_t peak_capacity = 0;
+};
+
+// Сводная статистика всех буферов RawMemory с элементами типа T
+template <typename T>
+class VectorTypeStats {
+public:
+    static VectorStats Get() noexcept {
+        VectorStats stats;
+        stats.allocations = allocations_.load(std::memory_order_relaxed);
+        stats.deallocations = deallocations_.load(std::memory_order_relaxed);
+        stats.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+        stats.elements_moved = elements_moved_.load(std::memory_order_relaxed);
+        stats.elements_copied = elements_copied_.load(std::memory_order_relaxed);
+        stats.elements_relocated = elements_relocated_.load(std::memory_order_relaxed);
+        stats.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    static void Reset() noexcept {
+        for (std::atomic<size_t>* counter : {&allocations_, &deallocations_, &bytes_allocated_, &elements_moved_,
+                                             &elements_copied_, &elements_relocated_, &peak_capacity_}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnAllocate(size_t capacity) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(capacity * sizeof(T), std::memory_order_relaxed);
+        OnCapacity(capacity);
+    }
+
+    static void OnDeallocate() noexcept {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void OnCapacity(size_t capacity) noexcept {
+        size_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while (peak < capacity && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnTransfer(size_t moved, size_t copied, size_t relocated) noexcept {
+        elements_moved_.fetch_add(moved, std::memory_order_relaxed);
+        elements_copied_.fetch_add(copied, std::memory_order_relaxed);
+        elements_relocated_.fetch_add(relocated, std::memory_order_relaxed);
+    }
+
+private:
+    static inline std::atomic<size_t> allocations_{0};
+    static inline std::atomic<size_t> deallocations_{0};
+    static inline std::atomic<size_t> bytes_allocated_{0};
+    static inline std::atomic<size_t> elements_moved_{0};
+    static inline std::atomic<size_t> elements_copied_{0};
+    static inline std::atomic<size_t> elements_relocated_{0};
+    static inline std::atomic<size_t> peak_capacity_{0};
+};
+
+// Счётчики одного вектора. Каждое событие учитывается и в VectorTypeStats<T>.
+// Без ADVANCED_VECTOR_STATS объект пуст, а его методы ничего не делают
+template <typename T>
+class VectorStatsRecorder {
+public:
+#ifdef ADVANCED_VECTOR_STATS
+    VectorStats Get() const noexcept {
+        return stats_;
+    }
+
+    void OnAllocate(size_t capacity) noexcept {
+        ++stats_.allocations;
+        stats_.bytes_allocated += capacity * sizeof(T);
+        OnCapacity(capacity);
+    }
+
+    void OnDeallocate() noexcept {
+        ++stats_.deallocations;
+    }
+
+    void OnCapacity(size_t capacity) noexcept {
+        if (capacity > stats_.peak_capacity) {
+            stats_.peak_capacity = capacity;
+        }
+    }
+
+    void OnTransfer(size_t moved, size_t copied, size_t relocated) noexcept {
+        stats_.elements_moved += moved;
+        stats_.elements_copied += copied;
+        stats_.elements_relocated += relocated;
+        VectorTypeStats<T>::OnTransfer(moved, copied, relocated);
+    }
+
+private:
+    VectorStats stats_;
+#else
+    VectorStats Get() const noexcept {
+        return {};
+    }
+
+    void OnAllocate(size_t) noexcept {
+    }
+
+    void OnDeallocate() noexcept {
+    }
+
+    void OnCapacity(size_t) noexcept {
+    }
+
+    void OnTransfer(size_t, size_t, size_t) noexcept {
+    }
+#endif
+};
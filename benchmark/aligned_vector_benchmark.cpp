@@ -0,0 +1,66 @@
+// Vector<float> против AlignedVector<float, 64>: Sum и поэлементное преобразование.
+// Перед замером проверяется, что буфер AlignedVector выровнен после каждого роста,
+// копирования и ShrinkToFit
+#include "../advanced-vector/aligned_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr size_t kAlign = 64;
+constexpr size_t kElements = (size_t{1} << 16) + 3;
+constexpr size_t kRuns = 2000;
+
+bool IsAligned(const float* data) {
+    return reinterpret_cast<uintptr_t>(data) % kAlign == 0;
+}
+
+void CheckAlignment() {
+    size_t failures = 0;
+    AlignedVector<float, kAlign> values;
+    size_t capacity = values.Capacity();
+    for (size_t i = 0; i < kElements; ++i) {
+        values.PushBack(static_cast<float>(i));
+        if (values.Capacity() != capacity) {
+            capacity = values.Capacity();
+            failures += !IsAligned(values.begin());
+        }
+    }
+    const AlignedVector<float, kAlign> copy(values);
+    failures += !IsAligned(copy.begin());
+    values.PopBack();
+    values.ShrinkToFit();
+    failures += !IsAligned(values.begin());
+    if (failures != 0) {
+        std::printf("AlignedVector buffer is misaligned: %zu\n", failures);
+    }
+}
+
+template <typename VectorType>
+void Run(const char* name) {
+    VectorType values;
+    for (size_t i = 0; i < kElements; ++i) {
+        values.PushBack(static_cast<float>(i % 1000));
+    }
+    PrintResult(std::string(name) + ": Sum", MeasureNs(kRuns, [&] {
+        DoNotOptimize(values.Sum());
+    }), kElements);
+    PrintResult(std::string(name) + ": x = 2x + 1", MeasureNs(kRuns, [&] {
+        for (float& value : values) {
+            value = value * 2.0f + 1.0f;
+        }
+        DoNotOptimize(values.begin());
+    }), kElements);
+}
+
+}  // namespace
+
+int main() {
+    CheckAlignment();
+    Run<Vector<float>>("Vector<float>");
+    Run<AlignedVector<float, kAlign>>("AlignedVector<float, 64>");
+}
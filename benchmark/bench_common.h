@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#if defined(__unix__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Не даёт компилятору выбросить вычисление value
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Запускает func iterations раз и возвращает среднее время одного запуска в наносекундах
+template <typename Func>
+double MeasureNs(size_t iterations, Func func) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        func();
+    }
+    const auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / iterations;
+}
+
+inline void PrintResult(const std::string& name, double ns_per_run, size_t ops_per_run) {
+    std::printf("%-48s %14.0f ns/run %10.2f ns/op\n", name.c_str(), ns_per_run, ns_per_run / ops_per_run);
+}
+
+// Пиковый резидентный размер процесса в килобайтах (0, если неизвестен)
+inline long PeakRssKb() {
+#if defined(__unix__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+// Запускает func в дочернем процессе, чтобы пиковый RSS измерялся для каждого случая отдельно
+template <typename Func>
+void RunIsolated(Func func) {
+#if defined(__unix__)
+    std::fflush(stdout);
+    const pid_t pid = fork();
+    if (pid == 0) {
+        func();
+        std::fflush(stdout);
+        _exit(0);
+    }
+    if (pid > 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+#endif
+    func();
+}
@@ -0,0 +1,94 @@
+// Множество посещённых вершин: Vector<bool> (байт на флаг) против BitVector (бит на флаг).
+// Для BitVector — Count, AND и обход единиц через FindNext на каждом уровне SIMD
+#include "../advanced-vector/bit_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr size_t kBits = size_t{1} << 26;
+constexpr size_t kRuns = 20;
+
+const char* LevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kGeneric:
+            return "generic";
+        case SimdLevel::kSse2:
+            return "sse2";
+        case SimdLevel::kAvx2:
+            return "avx2";
+        case SimdLevel::kAvx512:
+            return "avx512";
+    }
+    return "";
+}
+
+void RunMemory() {
+    RunIsolated([] {
+        const long before = PeakRssKb();
+        Vector<bool> flags;
+        for (size_t i = 0; i < kBits; ++i) {
+            flags.PushBack(i % 3 == 0);
+        }
+        DoNotOptimize(flags.Size());
+        std::printf("%-48s %14ld KB peak RSS growth\n", "Vector<bool>: PushBack", PeakRssKb() - before);
+    });
+    RunIsolated([] {
+        const long before = PeakRssKb();
+        BitVector<> flags;
+        for (size_t i = 0; i < kBits; ++i) {
+            flags.PushBack(i % 3 == 0);
+        }
+        DoNotOptimize(flags.Size());
+        std::printf("%-48s %14ld KB peak RSS growth\n", "BitVector: PushBack", PeakRssKb() - before);
+    });
+}
+
+void RunBulk() {
+    std::mt19937_64 rng(42);
+    BitVector<> lhs(kBits);
+    BitVector<> rhs(kBits);
+    for (size_t i = 0; i < kBits / 64; ++i) {
+        lhs.Set(rng() % kBits);
+        rhs.Set(rng() % kBits);
+    }
+    // Одна единица в среднем на 64 слова: обход почти целиком состоит из поиска ненулевых слов
+    BitVector<> sparse(kBits);
+    for (size_t i = 0; i < kBits / 4096; ++i) {
+        sparse.Set(rng() % kBits);
+    }
+    for (SimdLevel level : {SimdLevel::kGeneric, SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+        if (level > DetectSimdLevel()) {
+            break;
+        }
+        SimdLevelLimit().store(level);
+        const std::string prefix = std::string("BitVector ") + LevelName(level) + ": ";
+        PrintResult(prefix + "Count", MeasureNs(kRuns, [&] {
+            DoNotOptimize(lhs.Count());
+        }), kBits / 64);
+        PrintResult(prefix + "operator&=", MeasureNs(kRuns, [&] {
+            BitVector<> result(lhs);
+            result &= rhs;
+            DoNotOptimize(result.Words());
+        }), kBits / 64);
+        PrintResult(prefix + "FindFirst/FindNext, sparse", MeasureNs(kRuns, [&] {
+            size_t found = 0;
+            for (size_t i = sparse.FindFirst(); i != BitVector<>::kNotFound; i = sparse.FindNext(i)) {
+                ++found;
+            }
+            DoNotOptimize(found);
+        }), kBits / 64);
+    }
+    SimdLevelLimit().store(SimdLevel::kAvx512);
+}
+
+}  // namespace
+
+int main() {
+    RunMemory();
+    RunBulk();
+}
@@ -0,0 +1,60 @@
+// Масштабируемость дописывания из нескольких потоков: ConcurrentVector против
+// Vector под std::mutex. Все потоки вместе добавляют одно и то же число элементов
+#include "../advanced-vector/concurrent_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kTotalPushes = 1 << 22;
+
+// Запускает threads потоков, каждый из которых вызывает push(value) kTotalPushes / threads раз
+template <typename Push>
+double RunThreads(size_t threads, Push push) {
+    const size_t per_thread = kTotalPushes / threads;
+    return MeasureNs(1, [&] {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&push, t, per_thread] {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    push(static_cast<uint64_t>(t * per_thread + i));
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    });
+}
+
+}  // namespace
+
+int main() {
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    for (size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        const size_t ops = kTotalPushes / threads * threads;
+        {
+            ConcurrentVector<uint64_t> vector;
+            const double ns = RunThreads(threads, [&vector](uint64_t value) {
+                DoNotOptimize(vector.PushBack(value));
+            });
+            PrintResult("ConcurrentVector, " + std::to_string(threads) + " threads", ns, ops);
+        }
+        {
+            Vector<uint64_t> vector;
+            std::mutex mutex;
+            const double ns = RunThreads(threads, [&vector, &mutex](uint64_t value) {
+                std::lock_guard lock(mutex);
+                vector.PushBack(value);
+            });
+            PrintResult("Vector + std::mutex, " + std::to_string(threads) + " threads", ns, ops);
+        }
+    }
+}
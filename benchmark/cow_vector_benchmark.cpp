@@ -0,0 +1,46 @@
+// Снимки большого вектора: копия Vector против копии CowVector и цена первого
+// изменения после снимка, когда CowVector приходится копировать буфер
+#include "../advanced-vector/cow_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <string>
+
+namespace {
+
+constexpr size_t kElements = 1 << 20;
+constexpr size_t kSnapshots = 100;
+
+struct Route {
+    uint64_t prefix;
+    uint32_t next_hop;
+    uint32_t metric;
+};
+
+template <typename Container>
+void RunContainer(const std::string& name) {
+    Container routes;
+    for (size_t i = 0; i < kElements; ++i) {
+        routes.PushBack(Route{i, static_cast<uint32_t>(i % 64), 1});
+    }
+
+    PrintResult(name + ": snapshot", MeasureNs(kSnapshots, [&] {
+        Container snapshot(routes);
+        DoNotOptimize(snapshot.Size());
+    }), 1);
+
+    // Снимок живёт, пока исходный вектор изменяется: CowVector копирует буфер один раз
+    PrintResult(name + ": snapshot + first mutation", MeasureNs(kSnapshots, [&] {
+        Container snapshot(routes);
+        routes[0].metric += 1;
+        DoNotOptimize(snapshot.Size());
+    }), 1);
+}
+
+}  // namespace
+
+int main() {
+    RunContainer<Vector<Route>>("Vector<Route>");
+    RunContainer<CowVector<Route>>("CowVector<Route>");
+}
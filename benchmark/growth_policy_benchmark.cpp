@@ -0,0 +1,58 @@
+// Сравнение политик роста: множество векторов растут вперемешку без Reserve,
+// как при заполнении индекса. Печатает время и пиковый RSS для каждой политики
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kVectors = 2000;
+constexpr size_t kMaxElements = 20000;
+
+template <typename GrowthPolicy>
+void RunPolicy(const std::string& name) {
+    RunIsolated([&] {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<size_t> dist(1, kMaxElements);
+        std::vector<size_t> targets(kVectors);
+        size_t total = 0;
+        for (size_t& target : targets) {
+            target = dist(rng);
+            total += target;
+        }
+
+        const long rss_before = PeakRssKb();
+        Vector<Vector<uint32_t, std::allocator<uint32_t>, GrowthPolicy>> vectors(kVectors);
+        const double ns = MeasureNs(1, [&] {
+            // Векторы растут по очереди, чтобы освобождённые блоки перемежались с живыми
+            for (size_t round = 0; round < kMaxElements; ++round) {
+                for (size_t i = 0; i < kVectors; ++i) {
+                    if (round < targets[i]) {
+                        vectors[i].PushBack(static_cast<uint32_t>(round));
+                    }
+                }
+            }
+        });
+        size_t capacity = 0;
+        for (const auto& v : vectors) {
+            capacity += v.Capacity();
+        }
+        PrintResult(name, ns, total);
+        std::printf("  peak RSS growth %ld KiB, capacity overhead %.1f%%\n", PeakRssKb() - rss_before,
+                    100.0 * (capacity - total) / total);
+    });
+}
+
+}  // namespace
+
+int main() {
+    RunPolicy<DoublingGrowth>("DoublingGrowth");
+    RunPolicy<OneAndHalfGrowth>("OneAndHalfGrowth");
+    RunPolicy<SizeClassGrowth<>>("SizeClassGrowth<DoublingGrowth>");
+    RunPolicy<SizeClassGrowth<OneAndHalfGrowth>>("SizeClassGrowth<OneAndHalfGrowth>");
+    RunPolicy<CacheLineMinGrowth<>>("CacheLineMinGrowth<DoublingGrowth>");
+    RunPolicy<CacheLineMinGrowth<OneAndHalfGrowth>>("CacheLineMinGrowth<OneAndHalfGrowth>");
+}
@@ -0,0 +1,41 @@
+// Случайный доступ к большому вектору на обычных и на огромных страницах.
+// Размер в миллионах элементов можно передать первым аргументом
+#include "../advanced-vector/huge_page_allocator.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+
+constexpr size_t kLookups = size_t{1} << 24;
+
+template <typename Allocator>
+void RunRandomAccess(const std::string& name, size_t elements) {
+    Vector<uint64_t, Allocator> v(elements);
+    for (size_t i = 0; i < elements; ++i) {
+        v[i] = i * 0x9E3779B97F4A7C15ull;
+    }
+    uint64_t state = 88172645463325252ull;
+    uint64_t sum = 0;
+    const double ns = MeasureNs(1, [&] {
+        for (size_t i = 0; i < kLookups; ++i) {
+            // xorshift64: независимые от данных случайные индексы
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            sum += v[state % elements];
+        }
+    });
+    DoNotOptimize(sum);
+    PrintResult(name, ns, kLookups);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t elements = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64) * 1000000;
+    RunRandomAccess<std::allocator<uint64_t>>("random access, 4 KiB pages", elements);
+    RunRandomAccess<HugePageAllocator<uint64_t>>("random access, huge pages", elements);
+}
@@ -0,0 +1,105 @@
+// Версии большой последовательности, отличающиеся несколькими правками: полная копия
+// Vector на версию против ImmutableVector. Также построение, конкатенация, срез и чтение
+#include "../advanced-vector/immutable_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kElements = 1 << 20;
+constexpr size_t kVersions = 100;
+constexpr size_t kEditsPerVersion = 4;
+constexpr size_t kLookups = 1 << 22;
+
+void RunVersions() {
+    std::mt19937_64 rng(42);
+    Vector<uint64_t> vector;
+    TransientVector<uint64_t> builder;
+    PrintResult("Vector: PushBack", MeasureNs(1, [&] {
+        for (size_t i = 0; i < kElements; ++i) {
+            vector.PushBack(i);
+        }
+    }), kElements);
+    PrintResult("TransientVector: PushBack", MeasureNs(1, [&] {
+        for (size_t i = 0; i < kElements; ++i) {
+            builder.PushBack(i);
+        }
+    }), kElements);
+    const ImmutableVector<uint64_t> base = builder.Freeze();
+
+    std::vector<Vector<uint64_t>> vector_versions;
+    PrintResult("Vector: copy + edits per version", MeasureNs(kVersions, [&] {
+        Vector<uint64_t> version(vector_versions.empty() ? vector : vector_versions.back());
+        for (size_t edit = 0; edit < kEditsPerVersion; ++edit) {
+            version[rng() % kElements] = edit;
+        }
+        vector_versions.push_back(std::move(version));
+    }), kEditsPerVersion);
+
+    std::vector<ImmutableVector<uint64_t>> versions{base};
+    PrintResult("ImmutableVector: Set per version", MeasureNs(kVersions, [&] {
+        ImmutableVector<uint64_t> version = versions.back();
+        for (size_t edit = 0; edit < kEditsPerVersion; ++edit) {
+            version = version.Set(rng() % kElements, edit);
+        }
+        versions.push_back(std::move(version));
+    }), kEditsPerVersion);
+
+    PrintResult("ImmutableVector: PushBack per version", MeasureNs(kVersions, [&] {
+        versions.push_back(versions.back().PushBack(1));
+    }), 1);
+
+    PrintResult("ImmutableVector: Slice", MeasureNs(kVersions, [&] {
+        const size_t from = rng() % (kElements / 2);
+        DoNotOptimize(base.Slice(from, from + kElements / 2).Size());
+    }), 1);
+
+    PrintResult("ImmutableVector: Concat", MeasureNs(kVersions, [&] {
+        const size_t middle = rng() % kElements;
+        DoNotOptimize(base.Slice(middle, kElements).Concat(base.Slice(0, middle)).Size());
+    }), 1);
+
+    std::vector<size_t> indices(kLookups);
+    for (size_t& index : indices) {
+        index = rng() % kElements;
+    }
+    PrintResult("Vector: random access", MeasureNs(1, [&] {
+        uint64_t sum = 0;
+        for (size_t index : indices) {
+            sum += vector[index];
+        }
+        DoNotOptimize(sum);
+    }), kLookups);
+    PrintResult("ImmutableVector: random access", MeasureNs(1, [&] {
+        uint64_t sum = 0;
+        for (size_t index : indices) {
+            sum += base[index];
+        }
+        DoNotOptimize(sum);
+    }), kLookups);
+
+    PrintResult("Vector: iteration", MeasureNs(10, [&] {
+        uint64_t sum = 0;
+        for (uint64_t value : vector) {
+            sum += value;
+        }
+        DoNotOptimize(sum);
+    }), kElements);
+    PrintResult("ImmutableVector: iteration", MeasureNs(10, [&] {
+        uint64_t sum = 0;
+        for (uint64_t value : base) {
+            sum += value;
+        }
+        DoNotOptimize(sum);
+    }), kElements);
+}
+
+}  // namespace
+
+int main() {
+    RunVersions();
+}
@@ -0,0 +1,131 @@
+// Столбец значений с малым диапазоном: Vector<uint64_t> против PackedIntVector.
+// Для PackedIntVector — случайный доступ Get, Decode на каждом уровне SIMD
+// и PushBack для возрастающих, убывающих и пилообразных значений
+#include "../advanced-vector/packed_int_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr size_t kElements = size_t{1} << 24;
+constexpr size_t kLookups = size_t{1} << 20;
+constexpr size_t kRuns = 10;
+
+const char* LevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kGeneric:
+            return "generic";
+        case SimdLevel::kSse2:
+            return "sse2";
+        case SimdLevel::kAvx2:
+            return "avx2";
+        case SimdLevel::kAvx512:
+            return "avx512";
+    }
+    return "";
+}
+
+// Идентификаторы, растущие с небольшим разбросом: в блоке 128 значений умещаются в 12 бит
+uint64_t Value(size_t i) {
+    return (i << 4) + (i * 2654435761u) % 1024;
+}
+
+// Убывающие значения: каждое новое меньше минимума блока
+uint64_t Descending(size_t i) {
+    return Value(kElements - 1 - i);
+}
+
+// Короткие убывающие отрезки, каждый следующий начинается выше предыдущего
+uint64_t Sawtooth(size_t i) {
+    return ((i / 16) << 8) + (15 - i % 16) * 24;
+}
+
+template <typename Generate>
+void RunPushBack(const char* name, Generate generate) {
+    PrintResult(std::string("PackedIntVector: PushBack ") + name, MeasureNs(1, [&] {
+        PackedIntVector<> values;
+        for (size_t i = 0; i < kElements; ++i) {
+            values.PushBack(generate(i));
+        }
+        DoNotOptimize(values.Size());
+    }), kElements);
+}
+
+void RunMemory() {
+    RunIsolated([] {
+        const long before = PeakRssKb();
+        Vector<uint64_t> values;
+        for (size_t i = 0; i < kElements; ++i) {
+            values.PushBack(Value(i));
+        }
+        DoNotOptimize(values.Size());
+        std::printf("%-48s %14ld KB peak RSS growth\n", "Vector<uint64_t>: PushBack", PeakRssKb() - before);
+    });
+    RunIsolated([] {
+        const long before = PeakRssKb();
+        PackedIntVector<> values;
+        for (size_t i = 0; i < kElements; ++i) {
+            values.PushBack(Value(i));
+        }
+        DoNotOptimize(values.Size());
+        std::printf("%-48s %14ld KB peak RSS growth\n", "PackedIntVector: PushBack", PeakRssKb() - before);
+    });
+}
+
+void RunAccess() {
+    Vector<uint64_t> plain;
+    PackedIntVector<> packed;
+    for (size_t i = 0; i < kElements; ++i) {
+        plain.PushBack(Value(i));
+        packed.PushBack(Value(i));
+    }
+    std::printf("PackedIntVector: %zu bytes, Vector<uint64_t>: %zu bytes\n", packed.MemoryUsage(),
+                plain.Capacity() * sizeof(uint64_t));
+
+    std::mt19937_64 rng(42);
+    Vector<size_t> indexes;
+    for (size_t i = 0; i < kLookups; ++i) {
+        indexes.PushBack(rng() % kElements);
+    }
+    PrintResult("Vector<uint64_t>: random operator[]", MeasureNs(kRuns, [&] {
+        uint64_t sum = 0;
+        for (size_t index : indexes) {
+            sum += plain[index];
+        }
+        DoNotOptimize(sum);
+    }), kLookups);
+    PrintResult("PackedIntVector: random Get", MeasureNs(kRuns, [&] {
+        uint64_t sum = 0;
+        for (size_t index : indexes) {
+            sum += packed.Get(index);
+        }
+        DoNotOptimize(sum);
+    }), kLookups);
+
+    Vector<uint64_t> out(kElements);
+    for (SimdLevel level : {SimdLevel::kGeneric, SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+        if (level > DetectSimdLevel()) {
+            break;
+        }
+        SimdLevelLimit().store(level);
+        PrintResult(std::string("PackedIntVector ") + LevelName(level) + ": Decode", MeasureNs(kRuns, [&] {
+            packed.Decode(0, kElements, out.begin());
+            DoNotOptimize(out.begin());
+        }), kElements);
+    }
+    SimdLevelLimit().store(SimdLevel::kAvx512);
+}
+
+}  // namespace
+
+int main() {
+    RunMemory();
+    RunAccess();
+    RunPushBack("ascending", Value);
+    RunPushBack("descending", Descending);
+    RunPushBack("sawtooth", Sawtooth);
+}
@@ -0,0 +1,60 @@
+// Массовые операции над большим вектором в обычном и параллельном режиме:
+// конструирование по размеру, копирование, перенос при росте и разрушение
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr size_t kElements = size_t{1} << 24;
+
+// Нетривиальный тип: конструирование и разрушение нельзя заменить memset и пропустить
+struct Cell {
+    Cell() : value(1) {}
+    Cell(const Cell& other) : value(other.value + 1) {}
+    ~Cell() {
+        DoNotOptimize(value);
+    }
+
+    uint64_t value;
+};
+
+// Пул создаётся в дочернем процессе RunIsolated: потоки родителя не переживают fork
+void RunAll(size_t threads) {
+    const std::string mode = threads > 1 ? "parallel, " + std::to_string(threads) + " threads" : "sequential";
+    RunIsolated([&] {
+        if (threads > 1) {
+            BulkParallelism::Enable(threads);
+        }
+        Vector<Cell>* vector = nullptr;
+        PrintResult(mode + ": Vector(size_t)", MeasureNs(1, [&] {
+            vector = new Vector<Cell>(kElements);
+        }), kElements);
+
+        Vector<Cell>* copy = nullptr;
+        PrintResult(mode + ": copy constructor", MeasureNs(1, [&] {
+            copy = new Vector<Cell>(*vector);
+        }), kElements);
+
+        PrintResult(mode + ": Reserve relocation", MeasureNs(1, [&] {
+            copy->Reserve(2 * kElements);
+        }), kElements);
+
+        PrintResult(mode + ": destructor", MeasureNs(1, [&] {
+            delete copy;
+        }), kElements);
+        delete vector;
+        BulkParallelism::Disable();
+    });
+}
+
+}  // namespace
+
+int main() {
+    RunAll(1);
+    RunAll(std::max<size_t>(2, std::thread::hardware_concurrency()));
+}
@@ -0,0 +1,72 @@
+// Дозапись в PersistentVector против Vector в куче, повторное открытие файла
+// и проверка того, что файл с чужим заголовком отвергается
+#include "../advanced-vector/persistent_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr size_t kElements = size_t{1} << 22;
+constexpr size_t kRuns = 5;
+const std::string kPath = "persistent_vector_benchmark.bin";
+
+void RunPushBack() {
+    PrintResult("Vector<uint64_t>: PushBack", MeasureNs(kRuns, [] {
+        Vector<uint64_t> values;
+        for (size_t i = 0; i < kElements; ++i) {
+            values.PushBack(i);
+        }
+        DoNotOptimize(values.Size());
+    }), kElements);
+    PrintResult("PersistentVector<uint64_t>: PushBack", MeasureNs(kRuns, [] {
+        std::remove(kPath.c_str());
+        PersistentVector<uint64_t> values(kPath);
+        for (size_t i = 0; i < kElements; ++i) {
+            values.PushBack(i);
+        }
+        DoNotOptimize(values.Size());
+    }), kElements);
+}
+
+void RunReopen() {
+    PrintResult("PersistentVector<uint64_t>: reopen and sum", MeasureNs(kRuns, [] {
+        const PersistentVector<uint64_t> values(kPath);
+        uint64_t sum = 0;
+        for (uint64_t value : values) {
+            sum += value;
+        }
+        if (values.Size() != kElements || sum != kElements * (kElements - 1) / 2) {
+            std::printf("reopened vector does not match\n");
+        }
+    }), kElements);
+
+    PersistentVector<uint64_t> values(kPath);
+    PersistentVector<uint64_t> moved(std::move(values));
+    if (values.Size() != 0 || values.Capacity() != 0 || moved.Size() != kElements) {
+        std::printf("moved-from vector is not empty\n");
+    }
+}
+
+// Файл с другим размером элемента открываться не должен
+void CheckIncompatible() {
+    try {
+        const PersistentVector<uint32_t> values(kPath);
+        std::printf("incompatible file was opened\n");
+    } catch (const std::runtime_error&) {
+    }
+}
+
+}  // namespace
+
+int main() {
+    RunPushBack();
+    RunReopen();
+    CheckIncompatible();
+    std::remove(kPath.c_str());
+}
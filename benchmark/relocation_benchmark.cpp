@@ -0,0 +1,93 @@
+// Рост вектора без предварительного Reserve: тривиально переносимые типы
+// переносятся одним memcpy, остальные — поэлементным перемещением
+#include "../advanced-vector/malloc_allocator.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Дескриптор с пользовательскими перемещением и деструктором.
+// Relocatable управляет лишь тем, помечен ли тип как тривиально переносимый
+template <bool Relocatable>
+class Handle {
+public:
+    explicit Handle(int id) : id_(id) {}
+    Handle(Handle&& other) noexcept : id_(std::exchange(other.id_, -1)) {}
+    Handle(const Handle&) = delete;
+    ~Handle() {
+        if (id_ >= 0) {
+            DoNotOptimize(id_);
+        }
+    }
+
+private:
+    int id_;
+};
+
+// unique_ptr с собственным удалителем не помечен как тривиально переносимый
+struct Deleter {
+    void operator()(int* p) const noexcept { delete p; }
+};
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<Handle<true>> : std::true_type {};
+
+namespace {
+
+constexpr size_t kElements = 1 << 16;
+constexpr size_t kIterations = 200;
+
+template <typename T, typename Make>
+void RunGrowth(const std::string& name, Make make) {
+    const double ns = MeasureNs(kIterations, [&] {
+        Vector<T> v;
+        for (size_t i = 0; i < kElements; ++i) {
+            v.EmplaceBack(make(i));
+        }
+        DoNotOptimize(v.Size());
+    });
+    PrintResult(name + (IsTriviallyRelocatableV<T> ? " [relocatable]" : " [element-wise]"), ns, kElements);
+}
+
+// Рост большого буфера: MallocAllocator расширяет его на месте или через mremap
+void RunInPlaceGrowth() {
+    constexpr size_t kIngestElements = size_t{1} << 25;
+    MallocAllocatorBase::ResetReallocationStats();
+    const double ns = MeasureNs(1, [] {
+        Vector<uint64_t, MallocAllocator<uint64_t>> v;
+        for (uint64_t i = 0; i < kIngestElements; ++i) {
+            v.PushBack(i);
+        }
+        DoNotOptimize(v.Size());
+    });
+    PrintResult("Vector<uint64_t, MallocAllocator>", ns, kIngestElements);
+    const ReallocationStats stats = MallocAllocatorBase::GetReallocationStats();
+    std::printf("  bytes not copied: expanded in place %zu, remapped %zu, realloc in place %zu; copied %zu\n",
+                stats.expanded_in_place_bytes, stats.remapped_bytes, stats.realloc_in_place_bytes,
+                stats.copied_bytes);
+    const double std_ns = MeasureNs(1, [] {
+        Vector<uint64_t> v;
+        for (uint64_t i = 0; i < kIngestElements; ++i) {
+            v.PushBack(i);
+        }
+        DoNotOptimize(v.Size());
+    });
+    PrintResult("Vector<uint64_t>", std_ns, kIngestElements);
+}
+
+}  // namespace
+
+int main() {
+    RunGrowth<Handle<false>>("Vector<Handle>", [](size_t i) { return Handle<false>(static_cast<int>(i)); });
+    RunGrowth<Handle<true>>("Vector<Handle>", [](size_t i) { return Handle<true>(static_cast<int>(i)); });
+    RunGrowth<std::unique_ptr<int, Deleter>>("Vector<unique_ptr<int, Deleter>>", [](size_t) { return nullptr; });
+    RunGrowth<std::unique_ptr<int>>("Vector<unique_ptr<int>>", [](size_t) { return nullptr; });
+    RunGrowth<std::string>("Vector<string>", [](size_t) { return std::string(8, 'x'); });
+    RunInPlaceGrowth();
+}
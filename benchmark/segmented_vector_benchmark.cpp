@@ -0,0 +1,78 @@
+// SegmentedVector против Vector и Vector<unique_ptr>: заполнение без Reserve,
+// последовательный обход и случайный доступ по индексу
+#include "../advanced-vector/segmented_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kElements = 1 << 20;
+constexpr size_t kLookups = 1 << 22;
+
+// Запись, перенос которой при росте стоит заметно больше указателя
+struct Payload {
+    uint64_t key;
+    uint64_t data[7];
+};
+
+Payload MakePayload(size_t i) {
+    Payload payload{};
+    payload.key = i;
+    return payload;
+}
+
+const uint64_t& KeyOf(const Payload& payload) {
+    return payload.key;
+}
+
+const uint64_t& KeyOf(const std::unique_ptr<Payload>& payload) {
+    return payload->key;
+}
+
+template <typename Container, typename Make>
+void RunContainer(const std::string& name, Make make) {
+    RunIsolated([&] {
+        Container container;
+        PrintResult(name + ": PushBack", MeasureNs(1, [&] {
+            for (size_t i = 0; i < kElements; ++i) {
+                container.PushBack(make(i));
+            }
+        }), kElements);
+
+        PrintResult(name + ": iteration", MeasureNs(10, [&] {
+            uint64_t sum = 0;
+            for (const auto& value : container) {
+                sum += KeyOf(value);
+            }
+            DoNotOptimize(sum);
+        }), kElements);
+
+        std::mt19937_64 rng(42);
+        std::vector<size_t> indices(kLookups);
+        for (size_t& index : indices) {
+            index = rng() % kElements;
+        }
+        PrintResult(name + ": random access", MeasureNs(1, [&] {
+            uint64_t sum = 0;
+            for (size_t index : indices) {
+                sum += KeyOf(container[index]);
+            }
+            DoNotOptimize(sum);
+        }), kLookups);
+    });
+}
+
+}  // namespace
+
+int main() {
+    RunContainer<Vector<Payload>>("Vector<Payload>", MakePayload);
+    RunContainer<SegmentedVector<Payload>>("SegmentedVector<Payload>", MakePayload);
+    RunContainer<Vector<std::unique_ptr<Payload>>>("Vector<unique_ptr<Payload>>", [](size_t i) {
+        return std::make_unique<Payload>(MakePayload(i));
+    });
+}
@@ -0,0 +1,76 @@
+// Сохранение и загрузка Vector<uint64_t>: поэлементная запись через fwrite/fread
+// против Serialize/Deserialize и отображения файла MappedVectorView
+#include "../advanced-vector/vector.h"
+#include "../advanced-vector/vector_serialization.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr size_t kElements = size_t{1} << 24;
+constexpr size_t kRuns = 5;
+const std::string kPath = "serialization_benchmark.bin";
+
+void RunLoop(const Vector<uint64_t>& values) {
+    PrintResult("element loop: fwrite", MeasureNs(kRuns, [&] {
+        FILE* file = std::fopen(kPath.c_str(), "wb");
+        const uint64_t size = values.Size();
+        std::fwrite(&size, sizeof(size), 1, file);
+        for (uint64_t value : values) {
+            std::fwrite(&value, sizeof(value), 1, file);
+        }
+        std::fclose(file);
+    }), kElements);
+    PrintResult("element loop: fread", MeasureNs(kRuns, [&] {
+        FILE* file = std::fopen(kPath.c_str(), "rb");
+        uint64_t size = 0;
+        if (std::fread(&size, sizeof(size), 1, file) == 1) {
+            Vector<uint64_t> loaded;
+            loaded.Reserve(size);
+            uint64_t value = 0;
+            for (uint64_t i = 0; i < size && std::fread(&value, sizeof(value), 1, file) == 1; ++i) {
+                loaded.PushBack(value);
+            }
+            DoNotOptimize(loaded.Size());
+        }
+        std::fclose(file);
+    }), kElements);
+}
+
+void RunSerialize(const Vector<uint64_t>& values) {
+    PrintResult("Serialize", MeasureNs(kRuns, [&] {
+        Serialize(kPath, values);
+    }), kElements);
+    PrintResult("Deserialize", MeasureNs(kRuns, [&] {
+        Vector<uint64_t> loaded;
+        Deserialize(kPath, loaded);
+        DoNotOptimize(loaded.Size());
+    }), kElements);
+    PrintResult("MappedVectorView: open", MeasureNs(kRuns, [&] {
+        const MappedVectorView<uint64_t> view(kPath);
+        DoNotOptimize(view.Size());
+    }), kElements);
+    PrintResult("MappedVectorView: open and sum", MeasureNs(kRuns, [&] {
+        const MappedVectorView<uint64_t> view(kPath);
+        uint64_t sum = 0;
+        for (uint64_t value : view) {
+            sum += value;
+        }
+        DoNotOptimize(sum);
+    }), kElements);
+}
+
+}  // namespace
+
+int main() {
+    Vector<uint64_t> values;
+    for (size_t i = 0; i < kElements; ++i) {
+        values.PushBack(i * 2654435761u);
+    }
+    RunLoop(values);
+    RunSerialize(values);
+    std::remove(kPath.c_str());
+}
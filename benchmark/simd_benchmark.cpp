@@ -0,0 +1,69 @@
+// Поиск, подсчёт, сравнение и агрегаты над Vector<int32_t>, Vector<uint64_t> и Vector<float>
+// на каждом доступном уровне SIMD. Уровень generic — это алгоритмы std
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <string>
+
+namespace {
+
+constexpr size_t kElements = 1 << 16;
+constexpr size_t kRuns = 2000;
+
+const char* LevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kGeneric:
+            return "generic";
+        case SimdLevel::kSse2:
+            return "sse2";
+        case SimdLevel::kAvx2:
+            return "avx2";
+        case SimdLevel::kAvx512:
+            return "avx512";
+    }
+    return "";
+}
+
+template <typename T>
+void RunType(const std::string& type_name) {
+    Vector<T> vector;
+    for (size_t i = 0; i < kElements; ++i) {
+        vector.PushBack(static_cast<T>(i % 1000));
+    }
+    const Vector<T> copy(vector);
+    // Искомого значения нет: поиск проходит весь вектор
+    const T missing = static_cast<T>(-1);
+
+    for (SimdLevel level : {SimdLevel::kGeneric, SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+        if (level > DetectSimdLevel()) {
+            break;
+        }
+        SimdLevelLimit().store(level);
+        const std::string prefix = type_name + " " + LevelName(level) + ": ";
+        PrintResult(prefix + "Find", MeasureNs(kRuns, [&] {
+            DoNotOptimize(vector.Find(missing));
+        }), kElements);
+        PrintResult(prefix + "Count", MeasureNs(kRuns, [&] {
+            DoNotOptimize(vector.Count(static_cast<T>(7)));
+        }), kElements);
+        PrintResult(prefix + "operator==", MeasureNs(kRuns, [&] {
+            DoNotOptimize(vector == copy);
+        }), kElements);
+        PrintResult(prefix + "Min", MeasureNs(kRuns, [&] {
+            DoNotOptimize(vector.Min());
+        }), kElements);
+        PrintResult(prefix + "Sum", MeasureNs(kRuns, [&] {
+            DoNotOptimize(vector.Sum());
+        }), kElements);
+    }
+    SimdLevelLimit().store(SimdLevel::kAvx512);
+}
+
+}  // namespace
+
+int main() {
+    RunType<int32_t>("int32_t");
+    RunType<uint64_t>("uint64_t");
+    RunType<float>("float");
+}
@@ -0,0 +1,98 @@
+// Множество коротких векторов: Vector против SmallVector со встроенной ёмкостью.
+// Перед замером проверяются Swap, перемещение и копирование для всех сочетаний
+// встроенного и кучевого состояний
+#include "../advanced-vector/small_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr size_t kInline = 8;
+constexpr size_t kVectors = 200000;
+
+using Small = SmallVector<std::string, kInline>;
+
+// Размер kInline / 2 оставляет вектор встроенным, 4 * kInline переводит его в кучу
+Small MakeSmall(size_t size, char fill) {
+    Small vector;
+    for (size_t i = 0; i < size; ++i) {
+        vector.PushBack(std::string(24, static_cast<char>(fill + i % 8)));
+    }
+    return vector;
+}
+
+// Вектор из кучи может остаться там и с малым размером, но больше kInline элементов
+// встроенными быть не могут
+bool Matches(const Small& vector, size_t size, char fill) {
+    if (vector.Size() != size || (size > kInline && vector.IsInline())) {
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (vector[i] != std::string(24, static_cast<char>(fill + i % 8))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CheckStates() {
+    size_t failures = 0;
+    for (size_t lhs_size : {size_t{0}, kInline / 2, 4 * kInline}) {
+        for (size_t rhs_size : {size_t{0}, kInline / 2, 4 * kInline}) {
+            Small lhs = MakeSmall(lhs_size, 'a');
+            Small rhs = MakeSmall(rhs_size, 'k');
+            lhs.Swap(rhs);
+            failures += !Matches(lhs, rhs_size, 'k') || !Matches(rhs, lhs_size, 'a');
+
+            Small target = MakeSmall(lhs_size, 'a');
+            Small source = MakeSmall(rhs_size, 'k');
+            target = std::move(source);
+            failures += !Matches(target, rhs_size, 'k') || source.Size() != 0;
+
+            Small moved(std::move(target));
+            failures += !Matches(moved, rhs_size, 'k');
+
+            Small copy = MakeSmall(lhs_size, 'a');
+            copy = moved;
+            failures += !Matches(copy, rhs_size, 'k') || !Matches(moved, rhs_size, 'k');
+        }
+    }
+    if (failures != 0) {
+        std::printf("SmallVector state checks failed: %zu\n", failures);
+    }
+}
+
+template <typename MakeVector>
+uint64_t BuildMany(MakeVector make_vector) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kVectors; ++i) {
+        auto vector = make_vector();
+        const size_t size = 1 + i % kInline;
+        for (size_t j = 0; j < size; ++j) {
+            vector.PushBack(static_cast<uint32_t>(i + j));
+        }
+        sum += vector[size / 2];
+    }
+    return sum;
+}
+
+}  // namespace
+
+int main() {
+    CheckStates();
+    PrintResult("Vector<uint32_t>: short vectors", MeasureNs(1, [] {
+        DoNotOptimize(BuildMany([] {
+            return Vector<uint32_t>();
+        }));
+    }), kVectors);
+    PrintResult("SmallVector<uint32_t, 8>: short vectors", MeasureNs(1, [] {
+        DoNotOptimize(BuildMany([] {
+            return SmallVector<uint32_t, kInline>();
+        }));
+    }), kVectors);
+}
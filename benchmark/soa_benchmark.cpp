@@ -0,0 +1,79 @@
+// Обход одного поля широкой записи: Vector<Record> читает запись целиком,
+// SoAVector — только нужный столбец. Печатает время прохода и пропускную способность
+#include "../advanced-vector/soa_vector.h"
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <cstdint>
+
+namespace {
+
+constexpr size_t kRows = 1 << 22;
+constexpr size_t kRuns = 20;
+
+struct Record {
+    uint64_t id;
+    double price;
+    double weight;
+    uint32_t flags;
+    char name[36];
+};
+
+template <typename Scan>
+void Report(const std::string& name, size_t bytes_per_row, Scan scan) {
+    const double ns = MeasureNs(kRuns, scan);
+    PrintResult(name, ns, kRows);
+    std::printf("  %.2f GB/s of useful data\n", static_cast<double>(bytes_per_row * kRows) / ns);
+}
+
+}  // namespace
+
+int main() {
+    Vector<Record> records;
+    SoAVector<uint64_t, double, double, uint32_t> columns;
+    records.Reserve(kRows);
+    columns.Reserve(kRows);
+    for (size_t i = 0; i < kRows; ++i) {
+        Record record{};
+        record.id = i;
+        record.price = static_cast<double>(i % 1000);
+        record.weight = 1.0;
+        record.flags = static_cast<uint32_t>(i);
+        records.PushBack(record);
+        columns.PushBack(record.id, record.price, record.weight, record.flags);
+    }
+
+    Report("Vector<Record>: sum of price", sizeof(double), [&] {
+        double sum = 0;
+        for (const Record& record : records) {
+            sum += record.price;
+        }
+        DoNotOptimize(sum);
+    });
+
+    Report("SoAVector: sum of price column", sizeof(double), [&] {
+        double sum = 0;
+        for (double price : columns.Column<1>()) {
+            sum += price;
+        }
+        DoNotOptimize(sum);
+    });
+
+    Report("Vector<Record>: price * weight", 2 * sizeof(double), [&] {
+        double sum = 0;
+        for (const Record& record : records) {
+            sum += record.price * record.weight;
+        }
+        DoNotOptimize(sum);
+    });
+
+    Report("SoAVector: price * weight columns", 2 * sizeof(double), [&] {
+        const double* price = columns.Data<1>();
+        const double* weight = columns.Data<2>();
+        double sum = 0;
+        for (size_t i = 0; i < columns.Size(); ++i) {
+            sum += price[i] * weight[i];
+        }
+        DoNotOptimize(sum);
+    });
+}
@@ -0,0 +1,109 @@
+// Запрос строит несколько десятков временных векторов разного размера и выбрасывает их.
+// Vector с глобальной кучей против ArenaVector со сбросом арены после каждого запроса.
+// Во втором случае типы элементов чередуются, и буферы с разным выравниванием идут вперемешку
+#include "../advanced-vector/vector.h"
+#include "../advanced-vector/vector_arena.h"
+#include "bench_common.h"
+
+#include <cstdint>
+
+namespace {
+
+constexpr size_t kRequests = 20000;
+constexpr size_t kVectorsPerRequest = 48;
+
+size_t VectorSize(size_t request, size_t index) {
+    return 16 + (request * 31 + index * 97) % 500;
+}
+
+template <typename MakeVector>
+uint64_t BuildRequest(size_t request, MakeVector make_vector) {
+    uint64_t sum = 0;
+    for (size_t index = 0; index < kVectorsPerRequest; ++index) {
+        auto vector = make_vector();
+        const size_t size = VectorSize(request, index);
+        for (size_t i = 0; i < size; ++i) {
+            vector.PushBack(static_cast<uint32_t>(i ^ request));
+        }
+        sum += vector[size / 2];
+    }
+    return sum;
+}
+
+template <typename T, typename Vector>
+uint64_t FillOdd(Vector vector, size_t size) {
+    // Нечётные размеры оставляют конец буфера невыровненным для следующего типа
+    vector.Reserve(size | 1);
+    for (size_t i = 0; i < size; ++i) {
+        vector.PushBack(static_cast<T>(i));
+    }
+    return static_cast<uint64_t>(vector[size / 2]);
+}
+
+template <typename T>
+struct TypeTag {
+    using Type = T;
+};
+
+// make_vector(TypeTag<T>{}) возвращает пустой вектор из T
+template <typename MakeVector>
+uint64_t BuildMixedRequest(size_t request, MakeVector make_vector) {
+    uint64_t sum = 0;
+    for (size_t index = 0; index < kVectorsPerRequest; index += 3) {
+        const size_t size = VectorSize(request, index);
+        sum += FillOdd<char>(make_vector(TypeTag<char>{}), size);
+        sum += FillOdd<double>(make_vector(TypeTag<double>{}), size);
+        sum += FillOdd<uint32_t>(make_vector(TypeTag<uint32_t>{}), size);
+    }
+    return sum;
+}
+
+}  // namespace
+
+int main() {
+    PrintResult("Vector<uint32_t>: global heap", MeasureNs(1, [] {
+        uint64_t sum = 0;
+        for (size_t request = 0; request < kRequests; ++request) {
+            sum += BuildRequest(request, [] {
+                return Vector<uint32_t>();
+            });
+        }
+        DoNotOptimize(sum);
+    }), kRequests);
+
+    VectorArena arena;
+    PrintResult("ArenaVector<uint32_t>: Reset per request", MeasureNs(1, [&] {
+        uint64_t sum = 0;
+        for (size_t request = 0; request < kRequests; ++request) {
+            sum += BuildRequest(request, [&] {
+                return ArenaVector<uint32_t>(arena);
+            });
+            arena.Reset();
+        }
+        DoNotOptimize(sum);
+    }), kRequests);
+    std::printf("arena reserved %zu bytes\n", arena.ReservedBytes());
+
+    PrintResult("char/double/uint32_t: global heap", MeasureNs(1, [] {
+        uint64_t sum = 0;
+        for (size_t request = 0; request < kRequests; ++request) {
+            sum += BuildMixedRequest(request, [](auto tag) {
+                return Vector<typename decltype(tag)::Type>();
+            });
+        }
+        DoNotOptimize(sum);
+    }), kRequests);
+
+    VectorArena mixed;
+    PrintResult("char/double/uint32_t: arena, Reset per request", MeasureNs(1, [&] {
+        uint64_t sum = 0;
+        for (size_t request = 0; request < kRequests; ++request) {
+            sum += BuildMixedRequest(request, [&](auto tag) {
+                return ArenaVector<typename decltype(tag)::Type>(mixed);
+            });
+            mixed.Reset();
+        }
+        DoNotOptimize(sum);
+    }), kRequests);
+    std::printf("arena reserved %zu bytes\n", mixed.ReservedBytes());
+}
@@ -0,0 +1,344 @@
+// Сравнение Vector и std::vector на основных операциях для тривиального типа,
+// std::string, перемещаемого типа и типа с бросающими копированием и перемещением.
+// Для каждого случая печатаются нс/операцию, выделения памяти на операцию и прирост
+// пикового RSS. Каждый случай выполняется в отдельном процессе
+#include "../advanced-vector/vector.h"
+#include "bench_common.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> allocation_count{0};
+
+}  // namespace
+
+// Подсчёт выделений памяти: обе реализации используют std::allocator, то есть operator new.
+// GCC не видит, что замещённые operator new/delete согласованы, и предупреждает о free
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t bytes) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(bytes != 0 ? bytes : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+// Копирование и перемещение могут бросать: Vector и std::vector вынуждены копировать при росте
+class ThrowingCopy {
+public:
+    explicit ThrowingCopy(size_t value) : value_(std::to_string(value)) {}
+    ThrowingCopy() = default;
+    ThrowingCopy(const ThrowingCopy& other) noexcept(false) : value_(other.value_) {}
+    ThrowingCopy(ThrowingCopy&& other) noexcept(false) : value_(std::move(other.value_)) {}
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+    ThrowingCopy& operator=(ThrowingCopy&&) = default;
+
+private:
+    std::string value_;
+};
+
+template <typename T>
+T Make(size_t i);
+
+template <>
+int Make<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+template <>
+std::string Make<std::string>(size_t i) {
+    // Длиннее буфера SSO, чтобы строка владела памятью
+    return std::string(24, static_cast<char>('a' + i % 26));
+}
+
+template <>
+std::unique_ptr<int> Make<std::unique_ptr<int>>(size_t i) {
+    return std::make_unique<int>(static_cast<int>(i));
+}
+
+template <>
+ThrowingCopy Make<ThrowingCopy>(size_t i) {
+    return ThrowingCopy(i);
+}
+
+// Единый интерфейс к обоим контейнерам
+template <typename T>
+struct AdvancedVectorApi {
+    using ValueType = T;
+    using Container = Vector<T>;
+    static constexpr const char* kName = "Vector";
+
+    static void PushBack(Container& c, T value) {
+        c.PushBack(std::move(value));
+    }
+    static void EmplaceBack(Container& c, size_t i) {
+        c.EmplaceBack(Make<T>(i));
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.Reserve(n);
+    }
+    static void Resize(Container& c, size_t n) {
+        c.Resize(n);
+    }
+    static void Insert(Container& c, size_t index, T value) {
+        c.Insert(c.begin() + index, std::move(value));
+    }
+    static void Erase(Container& c, size_t index) {
+        c.Erase(c.begin() + index);
+    }
+    static void AppendRange(Container& c, const std::vector<T>& range) {
+        c.AppendRange(range);
+    }
+    static size_t Size(const Container& c) {
+        return c.Size();
+    }
+};
+
+template <typename T>
+struct StdVectorApi {
+    using ValueType = T;
+    using Container = std::vector<T>;
+    static constexpr const char* kName = "std::vector";
+
+    static void PushBack(Container& c, T value) {
+        c.push_back(std::move(value));
+    }
+    static void EmplaceBack(Container& c, size_t i) {
+        c.emplace_back(Make<T>(i));
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.reserve(n);
+    }
+    static void Resize(Container& c, size_t n) {
+        c.resize(n);
+    }
+    static void Insert(Container& c, size_t index, T value) {
+        c.insert(c.begin() + index, std::move(value));
+    }
+    static void Erase(Container& c, size_t index) {
+        c.erase(c.begin() + index);
+    }
+    static void AppendRange(Container& c, const std::vector<T>& range) {
+        c.insert(c.end(), range.begin(), range.end());
+    }
+    static size_t Size(const Container& c) {
+        return c.size();
+    }
+};
+
+constexpr size_t kAppendCount = 200000;
+constexpr size_t kShiftCount = 4000;
+constexpr size_t kAppendChunk = 100;
+constexpr size_t kRuns = 5;
+
+enum class Position { kFront, kMiddle, kBack };
+
+size_t IndexAt(Position position, size_t size) {
+    switch (position) {
+        case Position::kFront:
+            return 0;
+        case Position::kMiddle:
+            return size / 2;
+        case Position::kBack:
+            return size;
+    }
+    return size;
+}
+
+const char* PositionName(Position position) {
+    switch (position) {
+        case Position::kFront:
+            return "front";
+        case Position::kMiddle:
+            return "middle";
+        case Position::kBack:
+            return "back";
+    }
+    return "";
+}
+
+template <typename Api>
+typename Api::Container MakeFilled(size_t count) {
+    typename Api::Container c;
+    for (size_t i = 0; i < count; ++i) {
+        Api::PushBack(c, Make<typename Api::ValueType>(i));
+    }
+    return c;
+}
+
+using Cases = std::vector<std::function<void()>>;
+
+// Добавляет в cases случай, который в отдельном процессе kRuns раз готовит контейнер
+// вызовом setup и замеряет body(container), возвращающее число выполненных операций.
+// Выделения считаются только для body, прирост пикового RSS — для всего случая
+template <typename Api, typename Setup, typename Body>
+void AddCase(Cases& cases, const std::string& operation, const std::string& type_name, Setup setup, Body body) {
+    cases.push_back([operation, type_name, setup, body] {
+        RunIsolated([&] {
+            const long rss_before = PeakRssKb();
+            double total_ns = 0;
+            size_t total_ops = 0;
+            size_t allocations = 0;
+            for (size_t run = 0; run < kRuns; ++run) {
+                auto container = setup();
+                const size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+                const auto start = std::chrono::steady_clock::now();
+                total_ops += body(container);
+                total_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                allocations += allocation_count.load(std::memory_order_relaxed) - allocations_before;
+            }
+            std::printf("%-18s %-16s %-12s %10.2f ns/op %8.3f allocs/op %8ld KiB peak RSS\n", operation.c_str(),
+                        type_name.c_str(), Api::kName, total_ns / total_ops,
+                        static_cast<double>(allocations) / total_ops, PeakRssKb() - rss_before);
+        });
+    });
+}
+
+template <typename T, typename Api>
+Cases CollectCases(const std::string& type_name) {
+    Cases cases;
+    using Container = typename Api::Container;
+    const auto empty = [] {
+        return Container{};
+    };
+    const auto filled = [] {
+        return MakeFilled<Api>(kAppendCount);
+    };
+
+    AddCase<Api>(cases, "PushBack", type_name, empty, [](Container& c) {
+        for (size_t i = 0; i < kAppendCount; ++i) {
+            Api::PushBack(c, Make<T>(i));
+        }
+        return kAppendCount;
+    });
+
+    AddCase<Api>(cases, "EmplaceBack", type_name, empty, [](Container& c) {
+        for (size_t i = 0; i < kAppendCount; ++i) {
+            Api::EmplaceBack(c, i);
+        }
+        return kAppendCount;
+    });
+
+    AddCase<Api>(cases, "Reserve+PushBack", type_name, empty, [](Container& c) {
+        Api::Reserve(c, kAppendCount);
+        for (size_t i = 0; i < kAppendCount; ++i) {
+            Api::PushBack(c, Make<T>(i));
+        }
+        return kAppendCount;
+    });
+
+    if constexpr (std::is_copy_constructible_v<T>) {
+        std::vector<T> chunk;
+        for (size_t i = 0; i < kAppendChunk; ++i) {
+            chunk.push_back(Make<T>(i));
+        }
+        AddCase<Api>(cases, "AppendRange", type_name, empty, [chunk](Container& c) {
+            for (size_t i = 0; i < kAppendCount; i += kAppendChunk) {
+                Api::AppendRange(c, chunk);
+            }
+            return kAppendCount;
+        });
+    }
+
+    for (Position position : {Position::kFront, Position::kMiddle, Position::kBack}) {
+        AddCase<Api>(cases, std::string("Insert ") + PositionName(position), type_name, empty,
+                     [position](Container& c) {
+                         for (size_t i = 0; i < kShiftCount; ++i) {
+                             Api::Insert(c, IndexAt(position, Api::Size(c)), Make<T>(i));
+                         }
+                         return kShiftCount;
+                     });
+
+        AddCase<Api>(cases, std::string("Erase ") + PositionName(position), type_name,
+                     [] {
+                         return MakeFilled<Api>(kShiftCount);
+                     },
+                     [position](Container& c) {
+                         while (Api::Size(c) != 0) {
+                             const size_t index = IndexAt(position, Api::Size(c));
+                             Api::Erase(c, index == Api::Size(c) ? index - 1 : index);
+                         }
+                         return kShiftCount;
+                     });
+    }
+
+    if constexpr (std::is_copy_constructible_v<T>) {
+        AddCase<Api>(cases, "Copy assignment", type_name, filled, [](Container& c) {
+            Container target;
+            target = c;
+            DoNotOptimize(Api::Size(target));
+            return kAppendCount;
+        });
+    }
+
+    // Данные возвращаются в c, чтобы их разрушение не попало в замер
+    AddCase<Api>(cases, "Move assignment", type_name, filled, [](Container& c) {
+        Container target;
+        target = std::move(c);
+        DoNotOptimize(Api::Size(target));
+        c = std::move(target);
+        return size_t{2};
+    });
+
+    AddCase<Api>(cases, "Iteration", type_name, filled, [](Container& c) {
+        for (const T& value : c) {
+            DoNotOptimize(value);
+        }
+        return kAppendCount;
+    });
+
+    if constexpr (std::is_default_constructible_v<T>) {
+        AddCase<Api>(cases, "Resize", type_name, empty, [](Container& c) {
+            Api::Resize(c, kAppendCount);
+            Api::Resize(c, kAppendCount / 2);
+            return kAppendCount;
+        });
+    }
+    return cases;
+}
+
+// Строки Vector и std::vector для одной операции печатаются подряд
+template <typename T>
+void Compare(const std::string& type_name) {
+    const Cases advanced = CollectCases<T, AdvancedVectorApi<T>>(type_name);
+    const Cases standard = CollectCases<T, StdVectorApi<T>>(type_name);
+    for (size_t i = 0; i < advanced.size(); ++i) {
+        advanced[i]();
+        standard[i]();
+    }
+}
+
+}  // namespace
+
+int main() {
+    Compare<int>("int");
+    Compare<std::string>("string");
+    Compare<std::unique_ptr<int>>("unique_ptr<int>");
+    Compare<ThrowingCopy>("ThrowingCopy");
+}